@@ -1,4 +1,5 @@
 import os
+import platform
 import re
 import subprocess
 import sys
@@ -45,10 +46,19 @@ class CMakeBuild(build_ext):
         # from Python.
         cmake_args = [
             f"-DCMAKE_LIBRARY_OUTPUT_DIRECTORY={extdir}",
-            f"-DCMAKE_CXX_FLAGS=-march=x86-64-v3",
             f"-DPYTHON_EXECUTABLE={sys.executable}",
             f"-DCMAKE_BUILD_TYPE={cfg}",  # not used on MSVC, but no harm
         ]
+
+        # The baseline module is built for generic x86-64; on x86-64 hosts we
+        # additionally build variants for higher ISA levels, the best one
+        # supported by the CPU is selected when the package is imported.
+        # Override with PYOPERON_ISA_LEVELS (an empty value disables variants).
+        isa_levels = os.environ.get("PYOPERON_ISA_LEVELS")
+        if isa_levels is None and self.compiler.compiler_type != "msvc" and platform.machine().lower() in ("x86_64", "amd64"):
+            isa_levels = "x86-64-v2;x86-64-v3;x86-64-v4"
+        if isa_levels:
+            cmake_args += [f"-DPYOPERON_ISA_LEVELS={isa_levels}"]
         build_args = []
         # Adding CMake arguments set as environment variable
         # (needed e.g. to build for ARM OSx on conda-forge)
@@ -22,6 +22,14 @@ install(
     LIBRARY DESTINATION "${CMAKE_INSTALL_PREFIX}/pyoperon"
     )
 
+if(pyoperon_variant_targets)
+  install(
+      TARGETS ${pyoperon_variant_targets}
+      RUNTIME COMPONENT pyoperon_Runtime
+      LIBRARY DESTINATION "${CMAKE_INSTALL_PREFIX}/pyoperon"
+      )
+endif()
+
 install(
     FILES "${CMAKE_SOURCE_DIR}/pyoperon/__init__.py"
     FILES "${CMAKE_SOURCE_DIR}/pyoperon/sklearn.py"
@@ -0,0 +1,322 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_ARCHIVE_HPP
+#define PYOPERON_ARCHIVE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <operon/core/individual.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+#include "pyoperon/serialize.hpp"
+
+namespace pyoperon {
+
+// read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(std::string const& path)
+    {
+#if defined(_WIN32)
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) { throw std::runtime_error("Unable to open " + path); }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file_, &size) == 0) { throw std::runtime_error("Unable to stat " + path); }
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        if (size_ > 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_ == nullptr) { throw std::runtime_error("Unable to map " + path); }
+            data_ = static_cast<std::byte const*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            if (data_ == nullptr) { throw std::runtime_error("Unable to map " + path); }
+        }
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY); // NOLINT
+        if (fd_ < 0) { throw std::runtime_error("Unable to open " + path); }
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) { throw std::runtime_error("Unable to stat " + path); }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            auto* ptr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (ptr == MAP_FAILED) { throw std::runtime_error("Unable to map " + path); } // NOLINT
+            data_ = static_cast<std::byte const*>(ptr);
+        }
+#endif
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    auto operator=(MappedFile const&) -> MappedFile& = delete;
+
+    MappedFile(MappedFile&& other) noexcept { Swap(other); }
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&
+    {
+        MappedFile tmp(std::move(other));
+        Swap(tmp);
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+#if defined(_WIN32)
+        if (data_ != nullptr) { UnmapViewOfFile(data_); }
+        if (mapping_ != nullptr) { CloseHandle(mapping_); }
+        if (file_ != INVALID_HANDLE_VALUE) { CloseHandle(file_); }
+#else
+        if (data_ != nullptr) { ::munmap(const_cast<std::byte*>(data_), size_); } // NOLINT
+        if (fd_ >= 0) { ::close(fd_); }
+#endif
+    }
+
+    [[nodiscard]] auto Data() const -> std::byte const* { return data_; }
+    [[nodiscard]] auto Size() const -> std::size_t { return size_; }
+
+private:
+    void Swap(MappedFile& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#if defined(_WIN32)
+        std::swap(file_, other.file_);
+        std::swap(mapping_, other.mapping_);
+#else
+        std::swap(fd_, other.fd_);
+#endif
+    }
+
+    std::byte const* data_{nullptr};
+    std::size_t size_{0};
+#if defined(_WIN32)
+    HANDLE file_{INVALID_HANDLE_VALUE};
+    HANDLE mapping_{nullptr};
+#else
+    int fd_{-1};
+#endif
+};
+
+// appendable population archive made of two files:
+//
+//   <path>      header (16 bytes): char[4] magic "OPAR", uint16 version,
+//               uint16 objective count, uint8 scalar size, 7 reserved bytes
+//               followed by records: fitness values (objective count scalars)
+//               and the tree in the packed format from pyoperon/serialize.hpp
+//   <path>.idx  header (8 bytes): char[4] magic "OPAI", uint16 version,
+//               2 reserved bytes, followed by one uint64 record offset per record
+//
+// both files are memory-mapped for reading so that any record is located with
+// a single index lookup; the mapping is refreshed after every append. the
+// files are only opened for writing on the first append, so read-only use
+// never holds a write handle
+class Archive {
+public:
+    static constexpr std::array<char, 4> DataMagic { 'O', 'P', 'A', 'R' };
+    static constexpr std::array<char, 4> IndexMagic { 'O', 'P', 'A', 'I' };
+    static constexpr std::uint16_t Version { 1 };
+    static constexpr std::size_t DataHeaderSize { 16 };
+    static constexpr std::size_t IndexHeaderSize { 8 };
+
+    // opens an existing archive or creates a new one. when opening, an
+    // objective count of zero means "use whatever the archive contains"
+    explicit Archive(std::string path, std::size_t objectives = 0)
+        : path_(std::move(path))
+        , objectives_(objectives)
+    {
+        if (std::ifstream(path_, std::ios::binary).good()) {
+            Map();
+            ReadHeader();
+        } else {
+            if (objectives_ == 0) {
+                throw std::runtime_error("The objective count must be specified when creating a new archive.");
+            }
+            WriteHeaders();
+            Map();
+        }
+    }
+
+    [[nodiscard]] auto Path() const -> std::string const& { return path_; }
+    [[nodiscard]] auto ObjectiveCount() const -> std::size_t { return objectives_; }
+    [[nodiscard]] auto Size() const -> std::size_t { return (indexMap_.Size() - IndexHeaderSize) / sizeof(std::uint64_t); }
+
+    void Append(Operon::Span<Operon::Individual const> individuals)
+    {
+        if (!data_.is_open()) {
+            data_.open(path_, std::ios::binary | std::ios::app);
+            index_.open(IndexPath(), std::ios::binary | std::ios::app);
+        }
+        std::vector<std::byte> buf;
+        std::vector<std::byte> idx;
+        auto offset = static_cast<std::uint64_t>(dataMap_.Size());
+        for (auto const& ind : individuals) {
+            if (ind.Fitness.size() != objectives_) {
+                throw std::runtime_error("Individual objective count does not match the archive.");
+            }
+            auto pos = buf.size();
+            buf.resize(pos + objectives_ * sizeof(Operon::Scalar) + serialize::SerializedSize(ind.Genotype));
+            auto* p = buf.data() + pos;
+            for (auto f : ind.Fitness) { p = serialize::detail::Store(p, f); }
+            serialize::Write(ind.Genotype, p);
+
+            idx.resize(idx.size() + sizeof(std::uint64_t));
+            serialize::detail::Store(idx.data() + idx.size() - sizeof(std::uint64_t), offset + pos);
+        }
+        data_.write(reinterpret_cast<char const*>(buf.data()), static_cast<std::streamsize>(buf.size())); // NOLINT
+        index_.write(reinterpret_cast<char const*>(idx.data()), static_cast<std::streamsize>(idx.size())); // NOLINT
+        data_.flush();
+        index_.flush();
+        if (!data_ || !index_) {
+            throw std::runtime_error("Unable to write to archive " + path_);
+        }
+        Map();
+    }
+
+    void Append(Operon::Individual const& individual) { Append({ &individual, 1 }); }
+
+    [[nodiscard]] auto Fitness(std::size_t i) const -> std::vector<Operon::Scalar>
+    {
+        auto [p, size] = Record(i);
+        if (size < FitnessSize()) {
+            throw std::runtime_error("Corrupt archive record " + std::to_string(i) + ".");
+        }
+        std::vector<Operon::Scalar> fitness(objectives_);
+        for (auto& f : fitness) { p = serialize::detail::Load(p, f); }
+        return fitness;
+    }
+
+    [[nodiscard]] auto Tree(std::size_t i) const -> Operon::Tree
+    {
+        auto [p, size] = Record(i);
+        auto fsize = FitnessSize();
+        if (size < fsize) {
+            throw std::runtime_error("Corrupt archive record " + std::to_string(i) + ".");
+        }
+        return serialize::Read(p + fsize, size - fsize).first; // NOLINT
+    }
+
+    [[nodiscard]] auto operator[](std::size_t i) const -> Operon::Individual
+    {
+        Operon::Individual ind(objectives_);
+        auto fitness = Fitness(i);
+        std::copy(fitness.begin(), fitness.end(), ind.Fitness.begin());
+        ind.Genotype = Tree(i);
+        return ind;
+    }
+
+    [[nodiscard]] auto Trees(std::size_t begin, std::size_t end) const -> std::vector<Operon::Tree>
+    {
+        end = std::min(end, Size());
+        std::vector<Operon::Tree> trees;
+        trees.reserve(end > begin ? end - begin : 0);
+        for (auto i = begin; i < end; ++i) { trees.push_back(Tree(i)); }
+        return trees;
+    }
+
+private:
+    [[nodiscard]] auto IndexPath() const -> std::string { return path_ + ".idx"; }
+    [[nodiscard]] auto FitnessSize() const -> std::size_t { return objectives_ * sizeof(Operon::Scalar); }
+
+    [[nodiscard]] auto Offset(std::size_t i) const -> std::uint64_t
+    {
+        std::uint64_t offset{};
+        serialize::detail::Load(indexMap_.Data() + IndexHeaderSize + i * sizeof(std::uint64_t), offset); // NOLINT
+        return offset;
+    }
+
+    // start and size of the i-th record in the data file
+    [[nodiscard]] auto Record(std::size_t i) const -> std::pair<std::byte const*, std::size_t>
+    {
+        if (i >= Size()) {
+            throw std::out_of_range("Archive index out of range.");
+        }
+        auto begin = Offset(i);
+        auto end = i + 1 < Size() ? Offset(i + 1) : dataMap_.Size();
+        // offsets come from the index file and are not trusted
+        if (begin < DataHeaderSize || end < begin || end > dataMap_.Size()) {
+            throw std::runtime_error("Corrupt archive index entry " + std::to_string(i) + ".");
+        }
+        return { dataMap_.Data() + begin, end - begin }; // NOLINT
+    }
+
+    void Map()
+    {
+        dataMap_ = MappedFile(path_);
+        indexMap_ = MappedFile(IndexPath());
+    }
+
+    void WriteHeaders()
+    {
+        std::array<std::byte, DataHeaderSize> header{};
+        std::memcpy(header.data(), DataMagic.data(), DataMagic.size());
+        auto* p = header.data() + DataMagic.size();
+        p = serialize::detail::Store(p, Version);
+        p = serialize::detail::Store(p, static_cast<std::uint16_t>(objectives_));
+        serialize::detail::Store(p, static_cast<std::uint8_t>(sizeof(Operon::Scalar)));
+        std::ofstream(path_, std::ios::binary).write(reinterpret_cast<char const*>(header.data()), header.size()); // NOLINT
+
+        std::array<std::byte, IndexHeaderSize> index{};
+        std::memcpy(index.data(), IndexMagic.data(), IndexMagic.size());
+        serialize::detail::Store(index.data() + IndexMagic.size(), Version);
+        std::ofstream(IndexPath(), std::ios::binary).write(reinterpret_cast<char const*>(index.data()), index.size()); // NOLINT
+    }
+
+    void ReadHeader()
+    {
+        if (dataMap_.Size() < DataHeaderSize || std::memcmp(dataMap_.Data(), DataMagic.data(), DataMagic.size()) != 0) {
+            throw std::runtime_error(path_ + " is not a population archive.");
+        }
+        if (indexMap_.Size() < IndexHeaderSize || std::memcmp(indexMap_.Data(), IndexMagic.data(), IndexMagic.size()) != 0) {
+            throw std::runtime_error(IndexPath() + " is not a population archive index.");
+        }
+        std::uint16_t version{};
+        std::uint16_t objectives{};
+        std::uint8_t scalarSize{};
+        auto const* p = dataMap_.Data() + DataMagic.size();
+        p = serialize::detail::Load(p, version);
+        p = serialize::detail::Load(p, objectives);
+        serialize::detail::Load(p, scalarSize);
+
+        if (version != Version) {
+            throw std::runtime_error("Unsupported archive version " + std::to_string(version) + ".");
+        }
+        if (scalarSize != sizeof(Operon::Scalar)) {
+            throw std::runtime_error("The archive was written with a different scalar precision.");
+        }
+        if (objectives_ != 0 && objectives_ != objectives) {
+            throw std::runtime_error("The archive objective count does not match.");
+        }
+        objectives_ = objectives;
+    }
+
+    std::string path_;
+    std::size_t objectives_;
+    std::ofstream data_;
+    std::ofstream index_;
+    MappedFile dataMap_;
+    MappedFile indexMap_;
+};
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_ARENA_HPP
+#define PYOPERON_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace pyoperon {
+
+// per-thread monotonic arena for scratch buffers created in the offspring loop
+// (prediction and scaling buffers of the evaluators). memory is handed out by
+// bumping an offset and is never freed individually: an ArenaScope around each
+// evaluation rewinds the arena when the evaluation ends, keeping its chunks for
+// reuse, so the worker threads stop going through the global allocator once
+// their arenas are warm. buffers allocated from an arena must not outlive the
+// scope they were created in.
+class Arena {
+public:
+    static constexpr std::size_t DefaultChunkSize = std::size_t{1} << 20U; // 1 MiB
+
+    Arena() = default;
+    Arena(Arena const&) = delete;
+    Arena(Arena&&) = delete;
+    auto operator=(Arena const&) -> Arena& = delete;
+    auto operator=(Arena&&) -> Arena& = delete;
+    ~Arena() = default;
+
+    auto Allocate(std::size_t bytes, std::size_t alignment) -> void*
+    {
+        while (current_ < chunks_.size()) {
+            auto& chunk = chunks_[current_];
+            auto offset = (offset_ + alignment - 1) & ~(alignment - 1);
+            if (offset + bytes <= chunk.Size) {
+                offset_ = offset + bytes;
+                return chunk.Data.get() + offset;
+            }
+            ++current_;
+            offset_ = 0;
+        }
+
+        // alignment never exceeds max_align_t for the buffers we allocate here,
+        // and operator new[] returns storage suitably aligned for it
+        auto size = std::max(DefaultChunkSize, bytes + alignment);
+        chunks_.push_back({ std::make_unique<std::byte[]>(size), size }); // NOLINT
+        current_ = chunks_.size() - 1;
+        offset_ = bytes;
+        return chunks_.back().Data.get();
+    }
+
+    struct Marker {
+        std::size_t Chunk;
+        std::size_t Offset;
+    };
+
+    [[nodiscard]] auto Mark() const -> Marker { return { current_, offset_ }; }
+
+    // discard everything allocated after the given marker
+    void Rewind(Marker marker)
+    {
+        current_ = marker.Chunk;
+        offset_ = marker.Offset;
+    }
+
+    // make all chunks available again without returning them to the system allocator
+    void Release()
+    {
+        current_ = 0;
+        offset_ = 0;
+    }
+
+    // return the memory held by this arena to the system allocator
+    void Shrink()
+    {
+        chunks_.clear();
+        Release();
+    }
+
+    [[nodiscard]] auto Capacity() const -> std::size_t
+    {
+        std::size_t capacity{0};
+        for (auto const& c : chunks_) { capacity += c.Size; }
+        return capacity;
+    }
+
+    // the arena owned by the calling thread
+    static auto Local() -> Arena&
+    {
+        thread_local Arena arena;
+        return arena;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<std::byte[]> Data; // NOLINT
+        std::size_t Size;
+    };
+
+    std::vector<Chunk> chunks_;
+    std::size_t current_{0};
+    std::size_t offset_{0};
+};
+
+// releases the scratch memory allocated within a scope. scopes nest, so an
+// evaluator called from another evaluator rewinds only its own allocations
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena = Arena::Local())
+        : arena_(arena)
+        , marker_(arena.Mark())
+    {
+    }
+
+    ArenaScope(ArenaScope const&) = delete;
+    ArenaScope(ArenaScope&&) = delete;
+    auto operator=(ArenaScope const&) -> ArenaScope& = delete;
+    auto operator=(ArenaScope&&) -> ArenaScope& = delete;
+
+    ~ArenaScope() { arena_.Rewind(marker_); }
+
+private:
+    Arena& arena_;
+    Arena::Marker marker_;
+};
+
+// std-compatible allocator backed by an arena; deallocation is a no-op
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T; // NOLINT
+
+    ArenaAllocator() noexcept : arena_(&Arena::Local()) {}
+    explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(ArenaAllocator<U> const& other) noexcept : arena_(other.GetArena()) {} // NOLINT
+
+    auto allocate(std::size_t n) -> T* // NOLINT
+    {
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* /*unused*/, std::size_t /*unused*/) noexcept {} // NOLINT
+
+    [[nodiscard]] auto GetArena() const noexcept -> Arena* { return arena_; }
+
+    template<typename U>
+    auto operator==(ArenaAllocator<U> const& other) const noexcept -> bool { return arena_ == other.GetArena(); }
+
+    template<typename U>
+    auto operator!=(ArenaAllocator<U> const& other) const noexcept -> bool { return arena_ != other.GetArena(); }
+
+private:
+    Arena* arena_;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_BATCH_EVALUATOR_HPP
+#define PYOPERON_BATCH_EVALUATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <operon/core/problem.hpp>
+#include <operon/interpreter/interpreter.hpp>
+#include <operon/operators/evaluator.hpp>
+
+namespace pyoperon {
+
+// user defined evaluator which calls python once per batch of individuals
+// instead of once per individual. worker threads compute predictions without
+// the GIL and queue them; the thread that completes a batch (or whose request
+// has waited longer than the timeout) acquires the GIL once, calls the python
+// function with a (batch size x rows) prediction matrix and hands the returned
+// fitness values back to the waiting workers. the function must return either
+// one value per row (a single objective) or a (batch size x objectives)
+// matrix, where objectives is the count given at construction.
+//
+// since every worker waits for its own request, a batch never holds more
+// individuals than there are worker threads. a batch is therefore also flushed
+// as soon as every worker currently inside the evaluator is waiting, and the
+// timeout only covers workers that are busy elsewhere (e.g. selection or
+// variation) when the batch would fill. a batch size of zero selects the
+// number of hardware threads, which matches the algorithms' default of
+// threads=0; set it to the thread count passed to Run otherwise.
+class BatchUserDefinedEvaluator : public Operon::EvaluatorBase {
+public:
+    BatchUserDefinedEvaluator(Operon::Problem& problem, Operon::Interpreter& interpreter, pybind11::function function, std::size_t batchSize, double timeout, std::size_t objectives = 1)
+        : Operon::EvaluatorBase(problem)
+        , interpreter_(interpreter)
+        , function_(std::move(function))
+        , batchSize_(Clamp(batchSize))
+        , timeout_(timeout)
+        , objectives_(objectives)
+    {
+        if (objectives_ == 0) { throw std::invalid_argument("The objective count must be positive."); }
+    }
+
+    [[nodiscard]] auto ObjectiveCount() const -> std::size_t override { return objectives_; }
+
+    [[nodiscard]] auto BatchSize() const -> std::size_t { return batchSize_; }
+    void SetBatchSize(std::size_t batchSize) { batchSize_ = Clamp(batchSize); }
+
+    // milliseconds a request waits for its batch to fill up
+    [[nodiscard]] auto Timeout() const -> double { return timeout_; }
+    void SetTimeout(double timeout) { timeout_ = timeout; }
+
+    [[nodiscard]] auto BatchCount() const -> std::size_t { return batches_.load(); }
+
+    auto operator()(Operon::RandomGenerator& /*unused*/, Operon::Individual& ind, Operon::Span<Operon::Scalar> /*unused*/) const -> typename EvaluatorBase::ReturnType override
+    {
+        ++CallCount;
+        auto range = GetProblem().TrainingRange();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++active_;
+        }
+        Request request;
+        request.Predictions.resize(range.Size());
+        try {
+            interpreter_.get().Evaluate(ind.Genotype, GetProblem().GetDataset(), range, Operon::Span<Operon::Scalar>(request.Predictions), static_cast<Operon::Scalar*>(nullptr));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --active_;
+            throw;
+        }
+        ++ResidualEvaluations;
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        pending_.push_back(&request);
+        // called from python directly: nobody else will join the batch
+        if (Full() || PyGILState_Check() != 0) {
+            Flush(lock);
+        } else if (!cv_.wait_for(lock, std::chrono::duration<double, std::milli>(timeout_), [&] { return request.Done; })) {
+            Flush(lock);
+        }
+        cv_.wait(lock, [&] { return request.Done; });
+
+        // the remaining workers may all be waiting now
+        --active_;
+        if (!pending_.empty() && Full()) { Flush(lock); }
+
+        if (request.Error) { std::rethrow_exception(request.Error); }
+        return std::move(request.Fitness);
+    }
+
+private:
+    struct Request {
+        std::vector<Operon::Scalar> Predictions;
+        typename EvaluatorBase::ReturnType Fitness;
+        std::exception_ptr Error;
+        bool Done { false };
+    };
+
+    static auto Clamp(std::size_t batchSize) -> std::size_t
+    {
+        if (batchSize == 0) { batchSize = std::thread::hardware_concurrency(); }
+        return std::max(batchSize, std::size_t{1});
+    }
+
+    // whether the pending batch should be evaluated, called with the lock held
+    [[nodiscard]] auto Full() const -> bool { return pending_.size() >= std::min(batchSize_, active_); }
+
+    // evaluates all pending requests, called with the lock held
+    void Flush(std::unique_lock<std::mutex>& lock) const
+    {
+        std::vector<Request*> batch;
+        batch.swap(pending_);
+        if (batch.empty()) { return; }
+        lock.unlock();
+
+        std::exception_ptr error;
+        {
+            namespace py = pybind11;
+            py::gil_scoped_acquire acquire;
+            try {
+                auto const rows = batch.front()->Predictions.size();
+                py::array_t<Operon::Scalar> predictions({ batch.size(), rows });
+                auto* data = predictions.mutable_data();
+                for (std::size_t i = 0; i < batch.size(); ++i) {
+                    std::copy(batch[i]->Predictions.begin(), batch[i]->Predictions.end(), data + i * rows);
+                }
+                auto result = py::array_t<Operon::Scalar, py::array::c_style | py::array::forcecast>::ensure(function_(predictions));
+                if (!result || result.ndim() < 1 || result.ndim() > 2 || static_cast<std::size_t>(result.shape(0)) != batch.size()) {
+                    throw std::runtime_error("The batch evaluation function must return one fitness row per individual.");
+                }
+                auto const objectives = result.ndim() == 2 ? static_cast<std::size_t>(result.shape(1)) : std::size_t{1};
+                if (objectives != objectives_) {
+                    throw std::runtime_error("The batch evaluation function returned " + std::to_string(objectives) + " objectives, expected " + std::to_string(objectives_) + ".");
+                }
+                for (std::size_t i = 0; i < batch.size(); ++i) {
+                    auto const* row = result.data() + i * objectives;
+                    batch[i]->Fitness.assign(row, row + objectives);
+                }
+            } catch (py::error_already_set const& e) {
+                // do not let python objects escape to threads that do not hold the GIL
+                error = std::make_exception_ptr(std::runtime_error(e.what()));
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        lock.lock();
+        for (auto* request : batch) {
+            request->Error = error;
+            request->Done = true;
+        }
+        ++batches_;
+        cv_.notify_all();
+    }
+
+    std::reference_wrapper<Operon::Interpreter const> interpreter_;
+    pybind11::function function_;
+    std::size_t batchSize_;
+    double timeout_;
+    std::size_t objectives_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+    mutable std::vector<Request*> pending_;
+    mutable std::size_t active_ { 0 }; // workers inside operator(), guarded by mutex_
+    mutable std::atomic<std::size_t> batches_ { 0 };
+};
+
+} // namespace pyoperon
+
+#endif
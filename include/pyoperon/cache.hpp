@@ -0,0 +1,223 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_CACHE_HPP
+#define PYOPERON_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+namespace pyoperon {
+
+namespace detail {
+    inline auto HashTree(Operon::Tree const& tree, bool coefficients) -> std::uint64_t
+    {
+        constexpr std::uint64_t prime { 0x100000001b3ULL };
+        auto mix = [](std::uint64_t h, std::uint64_t v) {
+            h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6U) + (h >> 2U);
+            return h * prime;
+        };
+        std::uint64_t h { 0xcbf29ce484222325ULL };
+        for (auto const& n : tree.Nodes()) {
+            h = mix(h, static_cast<std::uint64_t>(n.Type));
+            h = mix(h, static_cast<std::uint64_t>(n.Arity));
+            h = mix(h, static_cast<std::uint64_t>(n.HashValue));
+            if (coefficients) {
+                auto value = static_cast<double>(n.Value);
+                std::uint64_t bits {};
+                std::memcpy(&bits, &value, sizeof(bits));
+                h = mix(h, bits);
+            }
+        }
+        return h;
+    }
+} // namespace detail
+
+// hash of the tree shape (node types, arities and variable hashes) which
+// ignores coefficient values, so that trees differing only in their
+// coefficients map to the same key
+inline auto StructuralHash(Operon::Tree const& tree) -> std::uint64_t
+{
+    return detail::HashTree(tree, /*coefficients=*/false);
+}
+
+// hash of the whole tree including coefficient values: equal trees evaluate
+// to the same predictions
+inline auto TreeHash(Operon::Tree const& tree) -> std::uint64_t
+{
+    return detail::HashTree(tree, /*coefficients=*/true);
+}
+
+// concurrent bounded cache of local optimization results keyed by structural
+// hash. the key space is split into shards with their own lock to keep
+// contention low when many evaluator threads look up entries at once. each
+// shard evicts its oldest entry when it is full.
+class CoefficientCache {
+public:
+    static constexpr std::size_t ShardCount { 16 };
+
+    struct Entry {
+        std::vector<Operon::Scalar> Coefficients;
+        Operon::Scalar Fitness;
+    };
+
+    explicit CoefficientCache(std::size_t capacity = 100'000)
+        : shardCapacity_(std::max(capacity / ShardCount, std::size_t{1}))
+    {
+    }
+
+    [[nodiscard]] auto Find(std::uint64_t key) const -> std::optional<Entry>
+    {
+        auto& shard = shards_[key % ShardCount];
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        if (auto it = shard.Entries.find(key); it != shard.Entries.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+        return std::nullopt;
+    }
+
+    void Insert(std::uint64_t key, Entry entry)
+    {
+        auto& shard = shards_[key % ShardCount];
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        auto [it, inserted] = shard.Entries.insert_or_assign(key, std::move(entry));
+        if (!inserted) { return; }
+        shard.Order.push_back(key);
+        if (shard.Order.size() > shardCapacity_) {
+            shard.Entries.erase(shard.Order.front());
+            shard.Order.pop_front();
+        }
+    }
+
+    void Clear()
+    {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            shard.Entries.clear();
+            shard.Order.clear();
+        }
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+    [[nodiscard]] auto Size() const -> std::size_t
+    {
+        std::size_t size { 0 };
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            size += shard.Entries.size();
+        }
+        return size;
+    }
+
+    [[nodiscard]] auto Capacity() const -> std::size_t { return shardCapacity_ * ShardCount; }
+    [[nodiscard]] auto Hits() const -> std::size_t { return hits_.load(); }
+    [[nodiscard]] auto Misses() const -> std::size_t { return misses_.load(); }
+
+private:
+    struct Shard {
+        mutable std::mutex Mutex;
+        std::unordered_map<std::uint64_t, Entry> Entries;
+        std::deque<std::uint64_t> Order;
+    };
+
+    std::size_t shardCapacity_;
+    mutable std::array<Shard, ShardCount> shards_;
+    mutable std::atomic<std::size_t> hits_ { 0 };
+    mutable std::atomic<std::size_t> misses_ { 0 };
+};
+
+// lock-free fitness memo keyed by TreeHash. the table has a fixed power of two
+// number of slots and each key maps to exactly one slot, so a newer entry
+// simply overwrites an older one. every slot is guarded by a sequence counter
+// (odd while being written): writers that find the slot busy give up instead
+// of waiting, and readers that observe a concurrent write report a miss.
+class FitnessMemo {
+public:
+    FitnessMemo(std::size_t capacity, std::size_t objectives)
+        : mask_(RoundUp(std::max(capacity, std::size_t{2})) - 1)
+        , objectives_(objectives)
+        , slots_(std::make_unique<Slot[]>(mask_ + 1)) // NOLINT
+        , values_(std::make_unique<std::atomic<Operon::Scalar>[]>((mask_ + 1) * objectives)) // NOLINT
+    {
+    }
+
+    [[nodiscard]] auto Find(std::uint64_t key, Operon::Span<Operon::Scalar> fitness) const -> bool
+    {
+        if (fitness.size() != objectives_) { return false; }
+        auto const i = key & mask_;
+        auto const& slot = slots_[i];
+        auto v1 = slot.Sequence.load(std::memory_order_acquire);
+        if ((v1 & 1U) != 0 || v1 == 0 || slot.Key.load(std::memory_order_relaxed) != key) { return false; }
+        for (std::size_t j = 0; j < objectives_; ++j) {
+            fitness[j] = values_[i * objectives_ + j].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.Sequence.load(std::memory_order_relaxed) == v1;
+    }
+
+    void Insert(std::uint64_t key, Operon::Span<Operon::Scalar const> fitness)
+    {
+        if (fitness.size() != objectives_) { return; }
+        auto const i = key & mask_;
+        auto& slot = slots_[i];
+        auto v = slot.Sequence.load(std::memory_order_relaxed);
+        if ((v & 1U) != 0 || !slot.Sequence.compare_exchange_strong(v, v + 1, std::memory_order_acquire)) {
+            return; // another writer owns the slot
+        }
+        // orders the odd sequence before the stores below, so a reader that
+        // sees any new value also sees the sequence change
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.Key.store(key, std::memory_order_relaxed);
+        for (std::size_t j = 0; j < objectives_; ++j) {
+            values_[i * objectives_ + j].store(fitness[j], std::memory_order_relaxed);
+        }
+        slot.Sequence.store(v + 2, std::memory_order_release);
+    }
+
+    void Clear()
+    {
+        for (std::size_t i = 0; i <= mask_; ++i) { slots_[i].Sequence.store(0, std::memory_order_relaxed); }
+    }
+
+    [[nodiscard]] auto Capacity() const -> std::size_t { return mask_ + 1; }
+    [[nodiscard]] auto ObjectiveCount() const -> std::size_t { return objectives_; }
+
+private:
+    static auto RoundUp(std::size_t n) -> std::size_t
+    {
+        std::size_t p { 1 };
+        while (p < n) { p <<= 1U; }
+        return p;
+    }
+
+    struct Slot {
+        std::atomic<std::uint64_t> Sequence { 0 };
+        std::atomic<std::uint64_t> Key { 0 };
+    };
+
+    std::size_t mask_;
+    std::size_t objectives_;
+    std::unique_ptr<Slot[]> slots_; // NOLINT
+    std::unique_ptr<std::atomic<Operon::Scalar>[]> values_; // NOLINT
+};
+
+} // namespace pyoperon
+
+#endif
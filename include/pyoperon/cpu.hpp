@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_CPU_HPP
+#define PYOPERON_CPU_HPP
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ISA level the module was compiled for, set by the build system for each
+// module variant (see PYOPERON_ISA_LEVELS in CMakeLists.txt). the baseline
+// module reports the x86-64 baseline on x86-64 hosts only
+#ifndef PYOPERON_ISA_LEVEL
+#if defined(__x86_64__) || defined(_M_X64)
+#define PYOPERON_ISA_LEVEL "x86-64"
+#else
+#define PYOPERON_ISA_LEVEL "generic"
+#endif
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+namespace pyoperon {
+
+// instruction set extensions of the host cpu that are part of the x86-64
+// microarchitecture levels (the compiler may emit any of them for -march)
+inline auto CpuFeatures() -> std::vector<std::pair<std::string, bool>>
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    // features that not every compiler knows by name are read from cpuid
+    unsigned int eax{};
+    unsigned int ebx{};
+    unsigned int ecx{};
+    unsigned int edx{};
+    auto const basic = __get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0 ? ecx : 0U;
+    auto const extended = __get_cpuid(0x80000001U, &eax, &ebx, &ecx, &edx) != 0 ? ecx : 0U;
+    auto bit = [](unsigned int reg, unsigned int n) { return ((reg >> n) & 1U) != 0; };
+    return {
+        { "sse3", bit(basic, 0) },
+        { "ssse3", bit(basic, 9) },
+        { "cx16", bit(basic, 13) },
+        { "sse4_1", bit(basic, 19) },
+        { "movbe", bit(basic, 22) },
+        { "f16c", bit(basic, 29) },
+        { "lahf", bit(extended, 0) },
+        { "lzcnt", bit(extended, 5) },
+        { "sse4_2", __builtin_cpu_supports("sse4.2") != 0 },
+        { "popcnt", __builtin_cpu_supports("popcnt") != 0 },
+        { "avx", __builtin_cpu_supports("avx") != 0 },
+        { "avx2", __builtin_cpu_supports("avx2") != 0 },
+        { "fma", __builtin_cpu_supports("fma") != 0 },
+        { "bmi", __builtin_cpu_supports("bmi") != 0 },
+        { "bmi2", __builtin_cpu_supports("bmi2") != 0 },
+        { "avx512f", __builtin_cpu_supports("avx512f") != 0 },
+        { "avx512bw", __builtin_cpu_supports("avx512bw") != 0 },
+        { "avx512cd", __builtin_cpu_supports("avx512cd") != 0 },
+        { "avx512dq", __builtin_cpu_supports("avx512dq") != 0 },
+        { "avx512vl", __builtin_cpu_supports("avx512vl") != 0 },
+    };
+#else
+    return {};
+#endif
+}
+
+// x86-64 microarchitecture levels supported by the host, best first
+inline auto SupportedIsaLevels() -> std::vector<std::string>
+{
+    auto features = CpuFeatures();
+    auto has = [&](std::initializer_list<char const*> names) {
+        return std::all_of(names.begin(), names.end(), [&](auto const* name) {
+            return std::any_of(features.begin(), features.end(), [&](auto const& f) { return f.first == name && f.second; });
+        });
+    };
+    // each level includes the previous one
+    auto const v2 = has({ "sse3", "ssse3", "sse4_1", "sse4_2", "popcnt", "cx16", "lahf" });
+    auto const v3 = v2 && has({ "avx", "avx2", "bmi", "bmi2", "f16c", "fma", "lzcnt", "movbe" });
+    auto const v4 = v3 && has({ "avx512f", "avx512bw", "avx512cd", "avx512dq", "avx512vl" });
+
+    std::vector<std::string> levels;
+    if (v4) { levels.emplace_back("x86-64-v4"); }
+    if (v3) { levels.emplace_back("x86-64-v3"); }
+    if (v2) { levels.emplace_back("x86-64-v2"); }
+    return levels;
+}
+
+} // namespace pyoperon
+
+#endif
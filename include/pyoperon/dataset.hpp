@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_DATASET_HPP
+#define PYOPERON_DATASET_HPP
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <operon/core/dataset.hpp>
+#include <operon/core/types.hpp>
+
+namespace pyoperon {
+
+// double precision copy of a dataset. the values are kept in float64 for
+// evaluation, while a float32 Operon::Dataset with the same variables (names,
+// hashes and indices) is kept alongside for the parts of the library that
+// only work in Operon::Scalar, e.g. the search itself. trees created against
+// either of them can be evaluated on both.
+class DoubleDataset {
+public:
+    using Matrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor>;
+
+    explicit DoubleDataset(Matrix values)
+        : values_(std::move(values))
+        , dataset_(Operon::Dataset::Matrix(values_.cast<Operon::Scalar>()))
+    {
+        Index();
+    }
+
+    [[nodiscard]] auto Rows() const -> std::size_t { return static_cast<std::size_t>(values_.rows()); }
+    [[nodiscard]] auto Cols() const -> std::size_t { return static_cast<std::size_t>(values_.cols()); }
+    [[nodiscard]] auto Values() const -> Matrix const& { return values_; }
+
+    // float32 dataset with the same variables
+    [[nodiscard]] auto Dataset() const -> Operon::Dataset const& { return dataset_; }
+
+    [[nodiscard]] auto VariableNames() const -> std::vector<std::string> { return dataset_.VariableNames(); }
+    void SetVariableNames(std::vector<std::string> const& names)
+    {
+        dataset_.SetVariableNames(names);
+        Index();
+    }
+
+    [[nodiscard]] auto GetValues(Operon::Hash hash) const -> Operon::Span<double const>
+    {
+        auto it = columns_.find(hash);
+        if (it == columns_.end()) {
+            throw std::runtime_error("Unknown variable hash " + std::to_string(hash) + ".");
+        }
+        return GetValues(it->second);
+    }
+
+    [[nodiscard]] auto GetValues(std::string const& name) const -> Operon::Span<double const>
+    {
+        for (auto const& v : dataset_.Variables()) {
+            if (v.Name == name) { return GetValues(static_cast<int>(v.Index)); }
+        }
+        throw std::runtime_error("Unknown variable " + name + ".");
+    }
+
+    [[nodiscard]] auto GetValues(int index) const -> Operon::Span<double const>
+    {
+        return { values_.col(index).data(), Rows() };
+    }
+
+private:
+    void Index()
+    {
+        columns_.clear();
+        for (auto const& v : dataset_.Variables()) { columns_[v.Hash] = static_cast<int>(v.Index); }
+    }
+
+    Matrix values_;
+    Operon::Dataset dataset_;
+    std::unordered_map<Operon::Hash, int> columns_;
+};
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,773 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_EVALUATOR_HPP
+#define PYOPERON_EVALUATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <operon/core/dataset.hpp>
+#include <operon/core/problem.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/interpreter/interpreter.hpp>
+#include <operon/operators/evaluator.hpp>
+#include <operon/optimizer/optimizer.hpp>
+#include <operon/random/random.hpp>
+
+#include "pyoperon/arena.hpp"
+#include "pyoperon/cache.hpp"
+#include "pyoperon/interval.hpp"
+#include "pyoperon/parallel.hpp"
+#include "pyoperon/primitives.hpp"
+#include "pyoperon/scaling.hpp"
+#include "pyoperon/simplify.hpp"
+
+namespace pyoperon {
+
+// nonlinear least squares backend used for local coefficient optimization
+enum class SolverType : int {
+    Auto,  // pick a backend from the problem size, see SelectSolver
+    Eigen, // Levenberg-Marquardt on dense Eigen matrices
+    Tiny,  // tiny-solver, lowest overhead for a handful of coefficients
+    Ceres  // ceres-solver, only available when operon was built with it
+};
+
+inline auto CeresAvailable() -> bool
+{
+#if defined(HAVE_CERES)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// heuristic backend choice: the overhead of tiny-solver is the lowest for small
+// coefficient vectors, while ceres pays off only for large jacobians
+inline auto SelectSolver(std::size_t coefficients, std::size_t rows) -> SolverType
+{
+    constexpr std::size_t tinyMaxCoefficients { 8 };
+    constexpr std::size_t ceresMinJacobianSize { std::size_t{1} << 22U }; // ~4M entries
+
+    if (coefficients <= tinyMaxCoefficients) { return SolverType::Tiny; }
+    if (CeresAvailable() && coefficients * rows >= ceresMinJacobianSize) { return SolverType::Ceres; }
+    return SolverType::Eigen;
+}
+
+namespace detail {
+    template<Operon::OptimizerType Type>
+    inline auto Optimize(Operon::Interpreter const& interpreter, Operon::Tree const& tree, Operon::Dataset const& dataset, Operon::Span<Operon::Scalar const> target, Operon::Range range, std::size_t iterations, Operon::OptimizerSummary& summary) -> std::vector<Operon::Scalar>
+    {
+        Operon::NonlinearLeastSquaresOptimizer<Type> optimizer(interpreter, tree, dataset);
+        auto coeff = optimizer.Optimize(target, range, iterations, summary);
+        return { coeff.begin(), coeff.end() };
+    }
+} // namespace detail
+
+// optimize the tree coefficients with the requested backend and return the
+// new coefficients. trees using a primitive without derivatives keep their
+// coefficients and get an unsuccessful summary
+inline auto Optimize(SolverType solver, Operon::Interpreter const& interpreter, Operon::Tree const& tree, Operon::Dataset const& dataset, Operon::Span<Operon::Scalar const> target, Operon::Range range, std::size_t iterations, Operon::OptimizerSummary& summary) -> std::vector<Operon::Scalar>
+{
+    if (!IsDifferentiable(tree)) {
+        summary = Operon::OptimizerSummary {};
+        auto coeff = tree.GetCoefficients();
+        return { coeff.begin(), coeff.end() };
+    }
+    if (solver == SolverType::Auto) {
+        solver = SelectSolver(tree.CoefficientsCount(), range.Size());
+    }
+    switch (solver) {
+    case SolverType::Tiny:
+        return detail::Optimize<Operon::OptimizerType::TINY>(interpreter, tree, dataset, target, range, iterations, summary);
+    case SolverType::Ceres:
+#if defined(HAVE_CERES)
+        return detail::Optimize<Operon::OptimizerType::CERES>(interpreter, tree, dataset, target, range, iterations, summary);
+#else
+        throw std::runtime_error("The ceres solver is not available in this build.");
+#endif
+    default:
+        return detail::Optimize<Operon::OptimizerType::EIGEN>(interpreter, tree, dataset, target, range, iterations, summary);
+    }
+}
+
+// error metric evaluator with a selectable local optimization backend. the
+// default is always Operon's Eigen Levenberg-Marquardt, while the backend of
+// Operon::Evaluator (which this class replaces in the bindings) is fixed when
+// operon is built. local optimization results can therefore differ from
+// earlier releases; pass the solver explicitly to pin it, SolverType::Auto
+// picks one per tree. it otherwise behaves like Operon::Evaluator:
+// coefficients are tuned for the configured number of iterations, then the
+// (optionally linearly scaled) prediction is scored against the training
+// target. the linear scaling is fitted block by block while the prediction
+// is computed (see ScaledEvaluate).
+// for MSE, RMSE and MAE the scaled prediction is never written: scale and
+// offset are applied inside the error pass. other metrics need the scaled
+// prediction and get it from one more pass into a scratch buffer, so the
+// output buffer always holds the unscaled prediction.
+//
+// with a nonzero batch size, coefficients are tuned on a window of BatchSize
+// consecutive training rows instead of the whole training range. the window
+// is redrawn every generation (see AdvanceGeneration) and is the same
+// for all individuals of a generation.
+//
+// fitness itself can be computed on a progressively growing sample: in the
+// first generation after construction (or ResetSchedule) a block covering
+// InitialFraction of the training rows is used, and the block grows linearly
+// until it covers the whole training range after SamplingGenerations
+// generations. the block is contiguous so that the interpreter streams
+// through memory, and its position is redrawn every generation. while the
+// schedule runs, the algorithm bindings re-score the parents on the new block
+// at every generation boundary (see RescoreSampled), so that parents and
+// offspring are always compared on the same rows, and once more on the full
+// training range when the run ends before the schedule completes. the final
+// population is thus always scored on the full range; note that the best
+// front of NSGA2 is selected during the run and is not re-scored.
+//
+// finally, when an abort threshold is set and the error is a plain sum of
+// residuals (MSE, RMSE or MAE without linear scaling), the prediction is
+// computed in blocks of BlockSize rows and the evaluation stops as soon as
+// the accumulated error proves that the final error cannot be below the
+// threshold. aborted individuals get the partial error as fitness, which is
+// a lower bound of their true error and is never below the threshold.
+//
+// an optional CoefficientCache (shared between evaluators of the same problem
+// and error metric) remembers optimized coefficients by tree structure. on a
+// hit the cached coefficients are used as the starting point of the solve,
+// and when neither mini-batches nor row sampling are active the solve and the
+// evaluation are skipped entirely in favour of the cached fitness.
+//
+// an optional FitnessMemo stores fitness values by full tree hash, so that
+// exact duplicates (clones) skip evaluation altogether when neither local
+// optimization, mini-batches nor row sampling are active (with local
+// optimization the stored fitness would belong to coefficients the clone does
+// not have; the CoefficientCache covers that case). keys are salted with the
+// problem, error metric and scaling mode, so one memo can be shared between
+// objectives. CacheHits counts the hits.
+//
+// when input bounds are set, every individual is evaluated with interval
+// arithmetic over them (one pass over the nodes, no data) after local
+// optimization, so that the coefficients that would be scored are checked.
+// individuals whose output can blow up or is undefined somewhere in the input
+// domain get the worst fitness instead of being scored. RejectedEvaluations
+// counts them.
+//
+// with Simplify enabled, the genotype of every evaluated individual is first
+// replaced by its algebraic simplification (see pyoperon::Simplify). since
+// the evaluator is called on offspring before they enter the population,
+// this keeps redundant structure out of the search.
+class Evaluator : public Operon::EvaluatorBase {
+public:
+    Evaluator(Operon::Problem& problem, Operon::Interpreter& interpreter, Operon::ErrorMetric const& error, bool linearScaling = true, SolverType solver = SolverType::Eigen)
+        : Operon::EvaluatorBase(problem)
+        , interpreter_(interpreter)
+        , error_(error)
+        , scaling_(linearScaling)
+        , solver_(solver)
+    {
+        if (dynamic_cast<Operon::MSE const*>(&error) != nullptr) {
+            accumulation_ = Accumulation::Squared;
+        } else if (dynamic_cast<Operon::RMSE const*>(&error) != nullptr) {
+            accumulation_ = Accumulation::RootSquared;
+        } else if (dynamic_cast<Operon::MAE const*>(&error) != nullptr) {
+            accumulation_ = Accumulation::Absolute;
+        }
+    }
+
+    [[nodiscard]] auto Solver() const -> SolverType { return solver_; }
+    void SetSolver(SolverType solver) { solver_ = solver; }
+
+    [[nodiscard]] auto BatchSize() const -> std::size_t { return batchSize_; }
+    void SetBatchSize(std::size_t batchSize) { batchSize_ = batchSize; }
+
+    [[nodiscard]] auto BatchSeed() const -> std::uint64_t { return batchSeed_; }
+    void SetBatchSeed(std::uint64_t seed) { batchSeed_ = seed; }
+
+    [[nodiscard]] auto InitialFraction() const -> double { return initialFraction_; }
+    void SetInitialFraction(double fraction)
+    {
+        if (!(fraction > 0 && fraction <= 1)) { throw std::invalid_argument("The initial fraction must be in (0, 1]."); }
+        initialFraction_ = fraction;
+    }
+
+    [[nodiscard]] auto SamplingGenerations() const -> std::size_t { return samplingGenerations_; }
+    void SetSamplingGenerations(std::size_t generations) { samplingGenerations_ = generations; }
+
+    // generation clock of this evaluator, advanced by the algorithm at the end
+    // of every generation. it drives the mini-batch window and the sampling
+    // schedule, so concurrent runs with their own evaluators do not interfere.
+    [[nodiscard]] auto Generation() const -> std::uint64_t { return generation_.load(std::memory_order_acquire); }
+    void AdvanceGeneration() const { generation_.fetch_add(1, std::memory_order_acq_rel); }
+
+    // restart the sampling schedule from the current generation
+    void ResetSchedule() { origin_ = Generation(); }
+
+    // fraction of the training rows used for fitness in the current generation
+    [[nodiscard]] auto SampleFraction() const -> double
+    {
+        auto generation = Generation() - origin_;
+        if (samplingGenerations_ == 0 || generation >= samplingGenerations_) { return 1.0; }
+        auto t = static_cast<double>(generation) / static_cast<double>(samplingGenerations_);
+        return initialFraction_ + (1.0 - initialFraction_) * t;
+    }
+
+    // the rows used for local optimization in the current generation
+    [[nodiscard]] auto OptimizationRange() const -> Operon::Range
+    {
+        return Window(batchSize_, batchSeed_);
+    }
+
+    // the rows used for fitness in the current generation
+    [[nodiscard]] auto FitnessRange() const -> Operon::Range
+    {
+        auto size = GetProblem().TrainingRange().Size();
+        auto rows = static_cast<std::size_t>(std::ceil(SampleFraction() * static_cast<double>(size)));
+        return Window(rows < size ? rows : 0, ~batchSeed_);
+    }
+
+    // NaN (the default) disables early abort
+    [[nodiscard]] auto AbortThreshold() const -> double { return threshold_.load(std::memory_order_relaxed); }
+    void SetAbortThreshold(double threshold) { threshold_.store(threshold, std::memory_order_relaxed); }
+
+    [[nodiscard]] auto BlockSize() const -> std::size_t { return blockSize_; }
+    void SetBlockSize(std::size_t blockSize) { blockSize_ = std::max(blockSize, std::size_t{1}); }
+
+    [[nodiscard]] auto AbortedEvaluations() const -> std::size_t { return aborted_.load(); }
+
+    // whether the error metric and scaling mode allow early abort
+    [[nodiscard]] auto SupportsAbort() const -> bool { return accumulation_ != Accumulation::None && !scaling_; }
+
+    // the cache is not owned by the evaluator and must outlive it (nullptr disables caching)
+    [[nodiscard]] auto Cache() const -> CoefficientCache* { return cache_; }
+    void SetCache(CoefficientCache* cache) { cache_ = cache; }
+
+    // the memo is not owned by the evaluator and must outlive it (nullptr disables memoization)
+    [[nodiscard]] auto Memo() const -> FitnessMemo* { return memo_; }
+    void SetMemo(FitnessMemo* memo) { memo_ = memo; }
+
+    [[nodiscard]] auto CacheHits() const -> std::size_t { return cacheHits_.load(); }
+
+    // per-variable input intervals for the pre-filter (empty disables it).
+    // every dataset variable except the target needs an interval, since the
+    // pre-filter runs on worker threads where a missing one cannot be reported
+    [[nodiscard]] auto Bounds() const -> VariableIntervals const& { return bounds_; }
+    void SetBounds(VariableIntervals bounds)
+    {
+        auto const& problem = GetProblem();
+        auto const& dataset = problem.GetDataset();
+        auto const* target = problem.TargetValues().data();
+        for (auto const& v : dataset.Variables()) {
+            if (!bounds.empty() && bounds.count(v.Hash) == 0 && dataset.GetValues(v.Hash).data() != target) {
+                throw std::invalid_argument("No interval is given for input variable " + v.Name + ".");
+            }
+        }
+        bounds_ = std::move(bounds);
+    }
+
+    [[nodiscard]] auto RejectedEvaluations() const -> std::size_t { return rejected_.load(); }
+
+    [[nodiscard]] auto Simplification() const -> bool { return simplify_; }
+    void SetSimplification(bool simplify) { simplify_ = simplify; }
+
+    // replaces the tree by its simplification when enabled
+    void SimplifyGenotype(Operon::Tree& tree) const
+    {
+        if (simplify_) { tree = Simplify(tree); }
+    }
+
+    // whether the interval pre-filter rejects the tree (counted as a rejection)
+    [[nodiscard]] auto Reject(Operon::Tree const& tree) const -> bool
+    {
+        if (bounds_.empty() || EvaluateInterval(tree, bounds_).IsBounded()) { return false; }
+        ++rejected_;
+        return true;
+    }
+
+    [[nodiscard]] auto GetInterpreter() const -> Operon::Interpreter const& { return interpreter_; }
+    [[nodiscard]] auto GetErrorMetric() const -> Operon::ErrorMetric const& { return error_; }
+    [[nodiscard]] auto LinearScaling() const -> bool { return scaling_; }
+
+    // tune the tree coefficients on the current optimization range
+    void LocalOptimize(Operon::Tree& tree) const
+    {
+        auto iterations = LocalOptimizationIterations();
+        if (iterations == 0 || tree.CoefficientsCount() == 0) { return; }
+        auto const& problem = GetProblem();
+        auto batch = OptimizationRange();
+        auto batchTarget = problem.TargetValues().subspan(batch.Start(), batch.Size());
+        Operon::OptimizerSummary summary{};
+        auto coeff = pyoperon::Optimize(solver_, interpreter_, tree, problem.GetDataset(), batchTarget, batch, iterations, summary);
+        ResidualEvaluations += summary.FunctionEvaluations;
+        JacobianEvaluations += summary.JacobianEvaluations;
+        if (summary.Success) { tree.SetCoefficients(coeff); }
+    }
+
+    // the unscaled prediction and the linear scaling of the last evaluation,
+    // used by MultiEvaluator to score further objectives on the same output
+    struct Prediction {
+        Operon::Span<Operon::Scalar const> Values; // empty unless the caller's buffer holds the whole prediction
+        double Scale { 1 };
+        double Offset { 0 };
+        bool Rejected { false }; // by the interval pre-filter
+    };
+
+    auto operator()(Operon::RandomGenerator& /*unused*/, Operon::Individual& ind, Operon::Span<Operon::Scalar> buf) const -> typename EvaluatorBase::ReturnType override
+    {
+        Prediction prediction;
+        return Evaluate(ind, buf, prediction);
+    }
+
+    // same as operator(), also reports the prediction left in buf. the
+    // prediction is not available after a memo or cache hit or an early abort
+    auto Evaluate(Operon::Individual& ind, Operon::Span<Operon::Scalar> buf, Prediction& prediction) const -> typename EvaluatorBase::ReturnType
+    {
+        ++CallCount;
+        auto const& problem = GetProblem();
+        auto range = FitnessRange();
+        auto target = problem.TargetValues().subspan(range.Start(), range.Size());
+        auto& tree = ind.Genotype;
+        SimplifyGenotype(tree);
+
+        auto iterations = LocalOptimizationIterations();
+        auto const exact = batchSize_ == 0 && SampleFraction() >= 1.0;
+        auto const memoizable = memo_ != nullptr && exact && iterations == 0;
+        auto const memoKey = memoizable ? MemoKey(tree) : std::uint64_t{0};
+
+        if (memoizable) {
+            typename EvaluatorBase::ReturnType fitness(1);
+            if (memo_->Find(memoKey, { fitness.data(), fitness.size() })) {
+                ++cacheHits_;
+                return fitness;
+            }
+        }
+
+        auto const cacheable = cache_ != nullptr && iterations > 0 && tree.CoefficientsCount() > 0;
+        auto const key = cacheable ? StructuralHash(tree) : std::uint64_t{0};
+
+        if (cacheable) {
+            if (auto entry = cache_->Find(key); entry && entry->Coefficients.size() == tree.CoefficientsCount()) {
+                tree.SetCoefficients(entry->Coefficients);
+                if (exact) { return typename EvaluatorBase::ReturnType { entry->Fitness }; }
+            }
+        }
+
+        LocalOptimize(tree);
+
+        // the pre-filter checks the coefficients that are scored below
+        if (Reject(tree)) {
+            prediction.Rejected = true;
+            return typename EvaluatorBase::ReturnType { std::numeric_limits<Operon::Scalar>::max() };
+        }
+
+        auto const external = buf.size() >= range.Size();
+        ArenaScope scope;
+        ArenaVector<Operon::Scalar> estimated;
+        if (!external) {
+            estimated.resize(range.Size());
+            buf = Operon::Span<Operon::Scalar>(estimated.data(), estimated.size());
+        }
+        buf = buf.subspan(0, range.Size());
+        ++ResidualEvaluations;
+
+        if (auto threshold = AbortThreshold(); SupportsAbort() && !std::isnan(threshold)) {
+            auto fit = static_cast<Operon::Scalar>(EvaluateBlockwise(tree, range, target, buf, threshold));
+            if (!std::isfinite(fit)) { fit = std::numeric_limits<Operon::Scalar>::max(); }
+            return typename EvaluatorBase::ReturnType { fit };
+        }
+
+        auto [a, b] = Predict(tree, range, target, buf);
+        auto fit = Error(buf, target, a, b);
+        if (external) { prediction = { buf, a, b, false }; }
+        if (cacheable && exact) {
+            auto coeff = tree.GetCoefficients();
+            cache_->Insert(key, { { coeff.begin(), coeff.end() }, fit });
+        }
+        if (memoizable) {
+            memo_->Insert(memoKey, { &fit, 1 });
+        }
+        return typename EvaluatorBase::ReturnType { fit };
+    }
+
+    // whether fitness is currently computed on a sample of the training rows
+    [[nodiscard]] auto Sampling() const -> bool { return SampleFraction() < 1.0; }
+
+    // fitness of the tree with its current coefficients on the given rows,
+    // without local optimization (used to re-score sampled individuals)
+    [[nodiscard]] auto Score(Operon::Tree const& tree, Operon::Range range) const -> Operon::Scalar
+    {
+        auto target = GetProblem().TargetValues().subspan(range.Start(), range.Size());
+        ArenaScope scope;
+        ArenaVector<Operon::Scalar> estimated(range.Size());
+        ++ResidualEvaluations;
+        Operon::Span<Operon::Scalar> buf(estimated.data(), estimated.size());
+        auto [a, b] = Predict(tree, range, target, buf);
+        return Error(buf, target, a, b);
+    }
+
+    // evaluates the tree into buf and returns the linear scaling (scale,
+    // offset) of the prediction, or (1, 0) without scaling. the scaling is
+    // fitted block by block while the prediction is produced and buf is left
+    // unscaled
+    auto Predict(Operon::Tree const& tree, Operon::Range range, Operon::Span<Operon::Scalar const> target, Operon::Span<Operon::Scalar> buf) const -> std::pair<double, double>
+    {
+        auto const& dataset = GetProblem().GetDataset();
+        if (!scaling_) {
+            interpreter_.get().Evaluate(tree, dataset, range, buf, static_cast<Operon::Scalar*>(nullptr));
+            return { 1.0, 0.0 };
+        }
+        auto scaling = ScaledEvaluate(interpreter_.get(), tree, dataset, range, target, buf, blockSize_);
+        return { scaling.Scale(), scaling.Offset() };
+    }
+
+    // error metric of scale * prediction + offset against target
+    auto Error(Operon::Span<Operon::Scalar const> prediction, Operon::Span<Operon::Scalar const> target, double scale, double offset) const -> Operon::Scalar
+    {
+        if (scale == 1 && offset == 0) {
+            return Finite(error_.get()(prediction, target));
+        }
+        if (accumulation_ != Accumulation::None) {
+            return Finite(ScaledError(prediction, target, scale, offset));
+        }
+        ArenaScope scope;
+        ArenaVector<Operon::Scalar> scaled(prediction.size());
+        std::transform(prediction.begin(), prediction.end(), scaled.begin(), [scale, offset](auto x) { return static_cast<Operon::Scalar>(x * scale + offset); });
+        return Finite(error_.get()(Operon::Span<Operon::Scalar const>(scaled.data(), scaled.size()), target));
+    }
+
+private:
+    enum class Accumulation { None, Squared, RootSquared, Absolute };
+
+    // memo entries are only valid for this problem, error metric and scaling mode
+    [[nodiscard]] auto MemoKey(Operon::Tree const& tree) const -> std::uint64_t
+    {
+        auto h = TreeHash(tree);
+        for (auto v : { reinterpret_cast<std::uintptr_t>(&GetProblem()), reinterpret_cast<std::uintptr_t>(&error_.get()), static_cast<std::uintptr_t>(scaling_) }) { // NOLINT
+            h ^= static_cast<std::uint64_t>(v) + 0x9e3779b97f4a7c15ULL + (h << 6U) + (h >> 2U);
+        }
+        return h;
+    }
+
+    // error of scale * prediction + offset for the accumulating metrics, in a
+    // single read of the prediction
+    auto ScaledError(Operon::Span<Operon::Scalar const> prediction, Operon::Span<Operon::Scalar const> target, double scale, double offset) const -> double
+    {
+        double sum { 0 };
+        for (std::size_t i = 0; i < prediction.size(); ++i) {
+            auto e = scale * static_cast<double>(prediction[i]) + offset - static_cast<double>(target[i]);
+            sum += accumulation_ == Accumulation::Absolute ? std::abs(e) : e * e;
+        }
+        auto error = prediction.empty() ? 0.0 : sum / static_cast<double>(prediction.size());
+        return accumulation_ == Accumulation::RootSquared ? std::sqrt(error) : error;
+    }
+
+    static auto Finite(double fit) -> Operon::Scalar
+    {
+        auto f = static_cast<Operon::Scalar>(fit);
+        return std::isfinite(f) ? f : std::numeric_limits<Operon::Scalar>::max();
+    }
+
+    // evaluate the error block by block and stop once it provably reaches the threshold
+    auto EvaluateBlockwise(Operon::Tree const& tree, Operon::Range range, Operon::Span<Operon::Scalar const> target, Operon::Span<Operon::Scalar> buf, double threshold) const -> double
+    {
+        auto const n = range.Size();
+        auto limit = (accumulation_ == Accumulation::RootSquared ? threshold * threshold : threshold) * static_cast<double>(n);
+        double sum{0};
+        for (std::size_t i = 0; i < n; i += blockSize_) {
+            auto m = std::min(blockSize_, n - i);
+            auto out = buf.subspan(i, m);
+            interpreter_.get().Evaluate(tree, GetProblem().GetDataset(), Operon::Range { range.Start() + i, range.Start() + i + m }, out, static_cast<Operon::Scalar*>(nullptr));
+            for (std::size_t j = 0; j < m; ++j) {
+                auto e = static_cast<double>(out[j]) - static_cast<double>(target[i + j]);
+                sum += accumulation_ == Accumulation::Absolute ? std::abs(e) : e * e;
+            }
+            if (!(sum < limit) && i + m < n) { // also stops on NaN
+                ++aborted_;
+                break;
+            }
+        }
+        auto error = sum / static_cast<double>(n);
+        return accumulation_ == Accumulation::RootSquared ? std::sqrt(error) : error;
+    }
+
+    // a window of the given size inside the training range, redrawn every
+    // generation. a size of zero selects the whole training range
+    [[nodiscard]] auto Window(std::size_t size, std::uint64_t seed) const -> Operon::Range
+    {
+        auto range = GetProblem().TrainingRange();
+        if (size == 0 || size >= range.Size()) { return range; }
+        Operon::RandomGenerator rng(seed + Generation());
+        std::uniform_int_distribution<std::size_t> dist(0, range.Size() - size);
+        auto start = range.Start() + dist(rng);
+        return { start, start + size };
+    }
+
+    std::reference_wrapper<Operon::Interpreter const> interpreter_;
+    std::reference_wrapper<Operon::ErrorMetric const> error_;
+    bool scaling_;
+    SolverType solver_;
+    std::size_t batchSize_{0};
+    std::uint64_t batchSeed_{0};
+    double initialFraction_{0.1};
+    std::size_t samplingGenerations_{0};
+    std::uint64_t origin_{0};
+    mutable std::atomic<std::uint64_t> generation_{0};
+    Accumulation accumulation_{Accumulation::None};
+    std::atomic<double> threshold_{std::numeric_limits<double>::quiet_NaN()};
+    std::size_t blockSize_{4096};
+    mutable std::atomic<std::size_t> aborted_{0};
+    CoefficientCache* cache_{nullptr};
+    FitnessMemo* memo_{nullptr};
+    mutable std::atomic<std::size_t> cacheHits_{0};
+    VariableIntervals bounds_;
+    mutable std::atomic<std::size_t> rejected_{0};
+    bool simplify_{false};
+};
+
+// scores a single prediction against several target columns and returns one
+// fitness value per target, so the tree is interpreted once per evaluation no
+// matter how many targets are screened. with linear scaling, every target gets
+// its own scaling coefficients. local optimization is not performed since the
+// coefficients can only be fitted for one target at a time.
+class MultiTargetEvaluator : public Operon::EvaluatorBase {
+public:
+    MultiTargetEvaluator(Operon::Problem& problem, Operon::Interpreter& interpreter, Operon::ErrorMetric const& error, std::vector<std::string> targets, bool linearScaling = true)
+        : Operon::EvaluatorBase(problem)
+        , interpreter_(interpreter)
+        , error_(error)
+        , targets_(std::move(targets))
+        , scaling_(linearScaling)
+    {
+        if (targets_.empty()) {
+            throw std::invalid_argument("At least one target is required.");
+        }
+    }
+
+    [[nodiscard]] auto Targets() const -> std::vector<std::string> const& { return targets_; }
+
+    [[nodiscard]] auto ObjectiveCount() const -> std::size_t override { return targets_.size(); }
+
+    auto operator()(Operon::RandomGenerator& /*unused*/, Operon::Individual& ind, Operon::Span<Operon::Scalar> buf) const -> typename EvaluatorBase::ReturnType override
+    {
+        ++CallCount;
+        auto const& dataset = GetProblem().GetDataset();
+        auto range = GetProblem().TrainingRange();
+
+        ArenaScope scope;
+        ArenaVector<Operon::Scalar> estimated;
+        if (buf.size() < range.Size()) {
+            estimated.resize(range.Size());
+            buf = Operon::Span<Operon::Scalar>(estimated.data(), estimated.size());
+        }
+        buf = buf.subspan(0, range.Size());
+        interpreter_.get().Evaluate(ind.Genotype, dataset, range, buf, static_cast<Operon::Scalar*>(nullptr));
+        ++ResidualEvaluations;
+
+        typename EvaluatorBase::ReturnType fitness(targets_.size());
+        ArenaVector<Operon::Scalar> scaled(scaling_ ? range.Size() : 0);
+        for (std::size_t i = 0; i < targets_.size(); ++i) {
+            auto target = dataset.GetValues(targets_[i]).subspan(range.Start(), range.Size());
+            Operon::Span<Operon::Scalar const> prediction = buf;
+            if (scaling_) {
+                auto [a, b] = Operon::FitLeastSquares(buf, target);
+                std::transform(buf.begin(), buf.end(), scaled.begin(), [a = a, b = b](auto x) { return static_cast<Operon::Scalar>(x * a + b); });
+                prediction = Operon::Span<Operon::Scalar const>(scaled.data(), scaled.size());
+            }
+            auto fit = static_cast<Operon::Scalar>(error_.get()(prediction, target));
+            fitness[i] = std::isfinite(fit) ? fit : std::numeric_limits<Operon::Scalar>::max();
+        }
+        return fitness;
+    }
+
+private:
+    std::reference_wrapper<Operon::Interpreter const> interpreter_;
+    std::reference_wrapper<Operon::ErrorMetric const> error_;
+    std::vector<std::string> targets_;
+    bool scaling_;
+};
+
+// combines several evaluators into a multi-objective one, like
+// Operon::MultiEvaluator, but interprets each individual only once: all
+// pyoperon::Evaluator objectives that target the same problem, use the same
+// interpreter and score on the full training range share one prediction
+// buffer and one set of linear scaling coefficients, and only their error
+// metrics are applied separately. the first such objective is evaluated as
+// usual (pre-filter, memo, coefficient cache, local optimization and early
+// abort are its own) and the others are scored on the prediction it leaves
+// behind. all other objectives (e.g. length or shape) are called as usual
+// and never see the prediction.
+class MultiEvaluator : public Operon::EvaluatorBase {
+public:
+    explicit MultiEvaluator(Operon::Problem& problem)
+        : Operon::EvaluatorBase(problem)
+    {
+    }
+
+    void Add(Operon::EvaluatorBase const& evaluator)
+    {
+        evaluators_.emplace_back(evaluator);
+    }
+
+    [[nodiscard]] auto ObjectiveCount() const -> std::size_t override
+    {
+        std::size_t count { 0 };
+        for (auto const& e : evaluators_) { count += e.get().ObjectiveCount(); }
+        return count;
+    }
+
+    // advances the generation clock of every pyoperon::Evaluator objective
+    void AdvanceGeneration() const
+    {
+        ForEachEvaluator([](Evaluator const& e, std::size_t /*unused*/) { e.AdvanceGeneration(); });
+    }
+
+    // calls f(evaluator, objective index) for every pyoperon::Evaluator objective
+    template<typename F>
+    void ForEachEvaluator(F&& f) const
+    {
+        std::size_t objective { 0 };
+        for (auto const& e : evaluators_) {
+            if (auto const* shared = dynamic_cast<Evaluator const*>(&e.get()); shared != nullptr) { f(*shared, objective); }
+            objective += e.get().ObjectiveCount();
+        }
+    }
+
+    // number of times a prediction was reused instead of being recomputed
+    [[nodiscard]] auto SharedEvaluations() const -> std::size_t { return shared_.load(); }
+
+    auto operator()(Operon::RandomGenerator& rng, Operon::Individual& ind, Operon::Span<Operon::Scalar> buf) const -> typename EvaluatorBase::ReturnType override
+    {
+        ++CallCount;
+        auto const& problem = GetProblem();
+        auto range = problem.TrainingRange();
+        auto target = problem.TargetValues().subspan(range.Start(), range.Size());
+
+        Evaluator const* lead { nullptr };
+        Evaluator::Prediction result;
+        std::optional<std::pair<double, double>> scaling; // of the prediction, when the lead does not scale
+        ArenaScope scope;
+        ArenaVector<Operon::Scalar> prediction;
+
+        typename EvaluatorBase::ReturnType fitness;
+        fitness.reserve(ObjectiveCount());
+
+        for (auto const& ref : evaluators_) {
+            auto const& evaluator = ref.get();
+            auto const* shared = dynamic_cast<Evaluator const*>(&evaluator);
+            if (shared == nullptr || &shared->GetProblem() != &problem || shared->FitnessRange().Size() != range.Size()
+                || (lead != nullptr && &shared->GetInterpreter() != &lead->GetInterpreter())) {
+                auto f = evaluator(rng, ind, buf);
+                fitness.insert(fitness.end(), f.begin(), f.end());
+                continue;
+            }
+
+            if (lead == nullptr) {
+                // the lead objective is a regular evaluation (pre-filter, memo,
+                // coefficient cache, local optimization and early abort)
+                lead = shared;
+                prediction.resize(range.Size());
+                auto f = lead->Evaluate(ind, Operon::Span<Operon::Scalar>(prediction.data(), prediction.size()), result);
+                fitness.insert(fitness.end(), f.begin(), f.end());
+                continue;
+            }
+
+            ++shared->CallCount;
+            ++shared_;
+
+            // the pre-filter of the first shared objective applies to all of them
+            if (result.Rejected) {
+                fitness.push_back(std::numeric_limits<Operon::Scalar>::max());
+                continue;
+            }
+
+            // the lead evaluation ended without a prediction (memo or cache hit,
+            // early abort), compute it once for the remaining objectives
+            if (result.Values.empty()) {
+                Operon::Span<Operon::Scalar> values(prediction.data(), prediction.size());
+                auto [a, b] = lead->Predict(ind.Genotype, range, target, values);
+                ++lead->ResidualEvaluations;
+                result.Values = values;
+                result.Scale = a;
+                result.Offset = b;
+            }
+
+            double a { 1 };
+            double b { 0 };
+            if (shared->LinearScaling()) {
+                if (lead->LinearScaling()) {
+                    a = result.Scale;
+                    b = result.Offset;
+                } else {
+                    if (!scaling) {
+                        LinearScaling s;
+                        s.Add(result.Values.data(), target.data(), result.Values.size());
+                        scaling = { s.Scale(), s.Offset() };
+                    }
+                    std::tie(a, b) = *scaling;
+                }
+            }
+            fitness.push_back(shared->Error(result.Values, target, a, b));
+        }
+        return fitness;
+    }
+
+private:
+    std::vector<std::reference_wrapper<Operon::EvaluatorBase const>> evaluators_;
+    mutable std::atomic<std::size_t> shared_ { 0 };
+};
+
+// helpers for the algorithm bindings, for an evaluator that is either a
+// pyoperon::Evaluator or a MultiEvaluator combining some (other evaluator
+// types are left alone)
+namespace detail {
+    template<typename F>
+    void ForEachEvaluator(Operon::EvaluatorBase const& evaluator, F&& f)
+    {
+        if (auto const* e = dynamic_cast<Evaluator const*>(&evaluator); e != nullptr) {
+            f(*e, std::size_t { 0 });
+        } else if (auto const* m = dynamic_cast<MultiEvaluator const*>(&evaluator); m != nullptr) {
+            m->ForEachEvaluator(f);
+        }
+    }
+} // namespace detail
+
+inline void AdvanceGeneration(Operon::EvaluatorBase const& evaluator)
+{
+    detail::ForEachEvaluator(evaluator, [](Evaluator const& e, std::size_t /*unused*/) { e.AdvanceGeneration(); });
+}
+
+// whether any objective is currently computed on a row sample
+inline auto IsSampling(Operon::EvaluatorBase const& evaluator) -> bool
+{
+    bool sampling { false };
+    detail::ForEachEvaluator(evaluator, [&](Evaluator const& e, std::size_t /*unused*/) { sampling = sampling || e.Sampling(); });
+    return sampling;
+}
+
+// re-scores the objectives that use progressive sampling, on their current
+// fitness range or (full = true) on the whole training range. coefficients
+// are not re-optimized.
+inline void RescoreSampled(Operon::EvaluatorBase const& evaluator, Operon::Span<Operon::Individual> individuals, bool full, std::size_t nthread)
+{
+    ParallelFor(individuals.size(), nthread, [&](std::size_t i) {
+        auto& ind = individuals[i];
+        detail::ForEachEvaluator(evaluator, [&](Evaluator const& e, std::size_t objective) {
+            if (e.SamplingGenerations() == 0 || objective >= ind.Fitness.size()) { return; }
+            ind.Fitness[objective] = e.Score(ind.Genotype, full ? e.GetProblem().TrainingRange() : e.FitnessRange());
+        });
+    });
+}
+
+} // namespace pyoperon
+
+#endif
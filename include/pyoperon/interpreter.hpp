@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_INTERPRETER_HPP
+#define PYOPERON_INTERPRETER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <operon/core/node.hpp>
+#include <operon/core/range.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+#include "pyoperon/primitives.hpp"
+#include "pyoperon/scaling.hpp"
+
+namespace pyoperon {
+
+// tree interpreter templated on the evaluation precision. it follows the
+// semantics of Operon::Interpreter (postfix evaluation in batches of rows,
+// n-ary arithmetic, one-argument subtraction and division meaning negation
+// and inversion) but keeps every intermediate result in T. Dynamic nodes are
+// evaluated by the plugin primitive registered under their hash. the kernels are
+// Eigen array expressions, so float and double each get their own
+// vectorized code paths.
+//
+// Data is any dataset type with GetValues(Operon::Hash) returning a span of
+// its values (Operon::Dataset or pyoperon::DoubleDataset); input values are
+// converted to T on the fly.
+template<typename T>
+class Interpreter {
+public:
+    static constexpr Eigen::Index BatchSize { 512 / sizeof(T) };
+
+    using Batch = Eigen::Array<T, BatchSize, Eigen::Dynamic, Eigen::ColMajor>;
+
+    // evaluates the tree over range into result. when coefficients is not
+    // null, it replaces the values of the optimizable leaf nodes (in tree
+    // order, as returned by Tree::GetCoefficients), which allows evaluating
+    // trees with coefficients in T precision.
+    template<typename Data>
+    void Evaluate(Operon::Tree const& tree, Data const& data, Operon::Range range, Operon::Span<T> result, T const* coefficients = nullptr) const
+    {
+        if (result.size() < range.Size()) { throw std::runtime_error("The result buffer is too small."); }
+        Run(tree, data, range, coefficients, [&](Eigen::Index row, auto const& output) {
+            Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>(result.data() + row, output.size()) = output;
+        });
+    }
+
+    template<typename Data>
+    auto Evaluate(Operon::Tree const& tree, Data const& data, Operon::Range range, T const* coefficients = nullptr) const -> std::vector<T>
+    {
+        std::vector<T> result(range.Size());
+        Evaluate(tree, data, range, Operon::Span<T>(result.data(), result.size()), coefficients);
+        return result;
+    }
+
+    // like Evaluate, but also fits target ~ scale * result + offset in the
+    // same pass: every batch of outputs is added to the scaling statistics
+    // while it is still in the batch matrix. target is aligned with range.
+    // the result is left unscaled.
+    template<typename Data, typename U>
+    auto ScaledEvaluate(Operon::Tree const& tree, Data const& data, Operon::Range range, Operon::Span<U const> target, Operon::Span<T> result, T const* coefficients = nullptr) const -> LinearScaling
+    {
+        if (result.size() < range.Size()) { throw std::runtime_error("The result buffer is too small."); }
+        if (target.size() < range.Size()) { throw std::runtime_error("The target is shorter than the range."); }
+        LinearScaling scaling;
+        Run(tree, data, range, coefficients, [&](Eigen::Index row, auto const& output) {
+            Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>(result.data() + row, output.size()) = output;
+            scaling.Add(output.data(), target.data() + row, static_cast<std::size_t>(output.size()));
+        });
+        return scaling;
+    }
+
+private:
+    // evaluates the tree batch by batch and hands the output of every batch
+    // (a column segment of rem rows) to sink(row offset, output)
+    template<typename Data, typename Sink>
+    void Run(Operon::Tree const& tree, Data const& data, Operon::Range range, T const* coefficients, Sink&& sink) const
+    {
+        auto const& nodes = tree.Nodes();
+        if (nodes.empty()) { throw std::runtime_error("Cannot evaluate an empty tree."); }
+
+        using Value = typename decltype(data.GetValues(Operon::Hash{}))::value_type;
+        std::vector<Value const*> inputs(nodes.size(), nullptr);
+        std::vector<T> values(nodes.size());
+        std::vector<Primitive const*> primitives(nodes.size(), nullptr);
+        std::size_t leaf { 0 };
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            auto const& n = nodes[i];
+            values[i] = static_cast<T>(n.Value);
+            if (n.IsLeaf() && n.Optimize && coefficients != nullptr) { values[i] = coefficients[leaf++]; }
+            if (n.IsVariable()) { inputs[i] = data.GetValues(n.HashValue).data(); }
+            if (n.Type == Operon::NodeType::Dynamic) {
+                primitives[i] = PrimitiveRegistry::Instance().Find(n.HashValue);
+                if (primitives[i] == nullptr) { throw std::runtime_error("No primitive is registered for a dynamic node."); }
+            }
+        }
+
+        Batch m(BatchSize, static_cast<Eigen::Index>(nodes.size()));
+        auto const rows = static_cast<Eigen::Index>(range.Size());
+        for (Eigen::Index row = 0; row < rows; row += BatchSize) {
+            auto const rem = std::min(BatchSize, rows - row);
+            auto const start = static_cast<Eigen::Index>(range.Start()) + row;
+
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                auto const& n = nodes[i];
+                auto const k = static_cast<Eigen::Index>(i);
+                auto r = m.col(k);
+
+                if (n.IsConstant()) {
+                    r.setConstant(values[i]);
+                    continue;
+                }
+                if (n.IsVariable()) {
+                    r.head(rem) = values[i] * Eigen::Map<Eigen::Array<Value, Eigen::Dynamic, 1> const>(inputs[i] + start, rem).template cast<T>();
+                    continue;
+                }
+
+                // first argument is the node right before this one, then jump over subtrees
+                auto j = k - 1;
+                auto next = [&]() { j -= static_cast<Eigen::Index>(nodes[static_cast<std::size_t>(j)].Length) + 1; return m.col(j); };
+
+                switch (n.Type) {
+                case Operon::NodeType::Add: {
+                    r = m.col(j);
+                    for (std::size_t a = 1; a < n.Arity; ++a) { r += next(); }
+                    break;
+                }
+                case Operon::NodeType::Mul: {
+                    r = m.col(j);
+                    for (std::size_t a = 1; a < n.Arity; ++a) { r *= next(); }
+                    break;
+                }
+                case Operon::NodeType::Sub: {
+                    if (n.Arity == 1) { r = -m.col(j); break; }
+                    r = m.col(j);
+                    for (std::size_t a = 1; a < n.Arity; ++a) { r -= next(); }
+                    break;
+                }
+                case Operon::NodeType::Div: {
+                    if (n.Arity == 1) { r = m.col(j).inverse(); break; }
+                    r = m.col(j);
+                    for (std::size_t a = 1; a < n.Arity; ++a) { r /= next(); }
+                    break;
+                }
+                case Operon::NodeType::Fmin: {
+                    r = m.col(j);
+                    for (std::size_t a = 1; a < n.Arity; ++a) { r = r.min(next()); }
+                    break;
+                }
+                case Operon::NodeType::Fmax: {
+                    r = m.col(j);
+                    for (std::size_t a = 1; a < n.Arity; ++a) { r = r.max(next()); }
+                    break;
+                }
+                case Operon::NodeType::Aq: {
+                    auto const& b = next();
+                    r = m.col(k - 1) / (T{1} + b.square()).sqrt();
+                    break;
+                }
+                case Operon::NodeType::Pow: {
+                    auto const& b = next();
+                    r = m.col(k - 1).pow(b);
+                    break;
+                }
+                case Operon::NodeType::Abs: { r = m.col(j).abs(); break; }
+                case Operon::NodeType::Acos: { r = m.col(j).acos(); break; }
+                case Operon::NodeType::Asin: { r = m.col(j).asin(); break; }
+                case Operon::NodeType::Atan: { r = m.col(j).atan(); break; }
+                case Operon::NodeType::Cbrt: { r = m.col(j).unaryExpr([](T x) { return std::cbrt(x); }); break; }
+                case Operon::NodeType::Ceil: { r = m.col(j).ceil(); break; }
+                case Operon::NodeType::Cos: { r = m.col(j).cos(); break; }
+                case Operon::NodeType::Cosh: { r = m.col(j).cosh(); break; }
+                case Operon::NodeType::Exp: { r = m.col(j).exp(); break; }
+                case Operon::NodeType::Floor: { r = m.col(j).floor(); break; }
+                case Operon::NodeType::Log: { r = m.col(j).log(); break; }
+                case Operon::NodeType::Logabs: { r = m.col(j).abs().log(); break; }
+                case Operon::NodeType::Log1p: { r = m.col(j).log1p(); break; }
+                case Operon::NodeType::Sin: { r = m.col(j).sin(); break; }
+                case Operon::NodeType::Sinh: { r = m.col(j).sinh(); break; }
+                case Operon::NodeType::Sqrt: { r = m.col(j).sqrt(); break; }
+                case Operon::NodeType::Sqrtabs: { r = m.col(j).abs().sqrt(); break; }
+                case Operon::NodeType::Tan: { r = m.col(j).tan(); break; }
+                case Operon::NodeType::Tanh: { r = m.col(j).tanh(); break; }
+                case Operon::NodeType::Square: { r = m.col(j).square(); break; }
+                case Operon::NodeType::Dynamic: {
+                    std::array<T const*, PYOPERON_PLUGIN_MAX_ARITY> args {};
+                    args[0] = m.col(j).data();
+                    for (std::size_t a = 1; a < n.Arity; ++a) { args[a] = next().data(); }
+                    primitives[i]->Evaluate(args.data(), static_cast<std::size_t>(BatchSize), r.data());
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Unsupported node type " + n.Name() + ".");
+                }
+            }
+            sink(row, m.col(m.cols() - 1).head(rem));
+        }
+    }
+};
+
+} // namespace pyoperon
+
+#endif
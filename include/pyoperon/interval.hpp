@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_INTERVAL_HPP
+#define PYOPERON_INTERVAL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <operon/core/dataset.hpp>
+#include <operon/core/node.hpp>
+#include <operon/core/range.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+namespace pyoperon {
+
+// closed interval [Lo, Hi]. infinite bounds mean the expression can blow up
+// (e.g. a division by an interval containing zero), NaN bounds mean that it
+// is undefined for part of the domain (e.g. the logarithm of negative values)
+struct Interval {
+    double Lo;
+    double Hi;
+
+    [[nodiscard]] auto IsDefined() const -> bool { return !std::isnan(Lo) && !std::isnan(Hi); }
+    [[nodiscard]] auto IsBounded() const -> bool { return std::isfinite(Lo) && std::isfinite(Hi); }
+};
+
+using VariableIntervals = std::unordered_map<Operon::Hash, Interval>;
+
+namespace detail::interval {
+    constexpr double Inf { std::numeric_limits<double>::infinity() };
+    constexpr double NaN { std::numeric_limits<double>::quiet_NaN() };
+    constexpr double Pi { 3.14159265358979323846 };
+
+    inline auto Undefined() -> Interval { return { NaN, NaN }; }
+    inline auto Unbounded() -> Interval { return { -Inf, Inf }; }
+
+    // product of two bounds where zero times infinity is zero
+    inline auto Product(double a, double b) -> double { return a == 0 || b == 0 ? 0.0 : a * b; }
+
+    inline auto Add(Interval a, Interval b) -> Interval { return { a.Lo + b.Lo, a.Hi + b.Hi }; }
+    inline auto Sub(Interval a, Interval b) -> Interval { return { a.Lo - b.Hi, a.Hi - b.Lo }; }
+    inline auto Neg(Interval a) -> Interval { return { -a.Hi, -a.Lo }; }
+
+    inline auto Mul(Interval a, Interval b) -> Interval
+    {
+        auto p1 = Product(a.Lo, b.Lo);
+        auto p2 = Product(a.Lo, b.Hi);
+        auto p3 = Product(a.Hi, b.Lo);
+        auto p4 = Product(a.Hi, b.Hi);
+        return { std::min({ p1, p2, p3, p4 }), std::max({ p1, p2, p3, p4 }) };
+    }
+
+    inline auto Inv(Interval a) -> Interval
+    {
+        if (a.Lo > 0 || a.Hi < 0) { return { 1 / a.Hi, 1 / a.Lo }; }
+        if (a.Lo == 0 && a.Hi > 0) { return { 1 / a.Hi, Inf }; }
+        if (a.Hi == 0 && a.Lo < 0) { return { -Inf, 1 / a.Lo }; }
+        return Unbounded(); // zero is inside
+    }
+
+    inline auto Div(Interval a, Interval b) -> Interval { return Mul(a, Inv(b)); }
+
+    inline auto Abs(Interval a) -> Interval
+    {
+        if (a.Lo >= 0) { return a; }
+        if (a.Hi <= 0) { return Neg(a); }
+        return { 0.0, std::max(-a.Lo, a.Hi) };
+    }
+
+    // image of a monotonically increasing function
+    template<typename F>
+    auto Increasing(Interval a, F&& f) -> Interval { return { f(a.Lo), f(a.Hi) }; }
+
+    inline auto Square(Interval a) -> Interval
+    {
+        auto b = Abs(a);
+        return { b.Lo * b.Lo, b.Hi * b.Hi };
+    }
+
+    inline auto Log(Interval a) -> Interval
+    {
+        if (a.Lo < 0) { return Undefined(); }
+        return Increasing(a, [](double x) { return std::log(x); }); // log(0) = -inf
+    }
+
+    inline auto Sqrt(Interval a) -> Interval
+    {
+        if (a.Lo < 0) { return Undefined(); }
+        return Increasing(a, [](double x) { return std::sqrt(x); });
+    }
+
+    // sin over an interval: the extrema are reached at the bounds or at the
+    // points pi/2 + 2k pi (maximum) and -pi/2 + 2k pi (minimum) inside it
+    inline auto Sin(Interval a) -> Interval
+    {
+        if (!a.IsBounded()) { return { -1.0, 1.0 }; }
+        if (a.Hi - a.Lo >= 2 * Pi) { return { -1.0, 1.0 }; }
+        auto contains = [&](double phase) {
+            auto k = std::ceil((a.Lo - phase) / (2 * Pi));
+            return phase + k * 2 * Pi <= a.Hi;
+        };
+        auto lo = std::min(std::sin(a.Lo), std::sin(a.Hi));
+        auto hi = std::max(std::sin(a.Lo), std::sin(a.Hi));
+        if (contains(Pi / 2)) { hi = 1.0; }
+        if (contains(-Pi / 2)) { lo = -1.0; }
+        return { lo, hi };
+    }
+
+    inline auto Cos(Interval a) -> Interval { return Sin({ a.Lo + Pi / 2, a.Hi + Pi / 2 }); }
+
+    inline auto Tan(Interval a) -> Interval
+    {
+        if (!a.IsBounded() || a.Hi - a.Lo >= Pi) { return Unbounded(); }
+        // poles at pi/2 + k pi
+        auto k = std::ceil((a.Lo - Pi / 2) / Pi);
+        if (Pi / 2 + k * Pi <= a.Hi) { return Unbounded(); }
+        return Increasing(a, [](double x) { return std::tan(x); });
+    }
+
+    inline auto Pow(Interval a, Interval b) -> Interval
+    {
+        // only positive bases are well defined for arbitrary exponents
+        if (a.Lo > 0 || (a.Lo == 0 && b.Lo > 0)) {
+            auto e = Mul(b, Log(a));
+            return Increasing(e, [](double x) { return std::exp(x); });
+        }
+        if (b.Lo == b.Hi && b.Lo == std::round(b.Lo)) {
+            // integer exponent
+            if (b.Lo < 0 && a.Lo <= 0 && a.Hi >= 0) { return Unbounded(); }
+            auto p1 = std::pow(a.Lo, b.Lo);
+            auto p2 = std::pow(a.Hi, b.Lo);
+            Interval r { std::min(p1, p2), std::max(p1, p2) };
+            auto even = std::fmod(b.Lo, 2.0) == 0;
+            if (even && a.Lo < 0 && a.Hi > 0 && b.Lo > 0) { r.Lo = 0; }
+            return r;
+        }
+        return Undefined();
+    }
+} // namespace detail::interval
+
+// bounds of the tree output for input variables within the given intervals,
+// computed in one postfix pass without touching any data. the result is
+// conservative: the true range of the tree is contained in it.
+inline auto EvaluateInterval(Operon::Tree const& tree, VariableIntervals const& variables) -> Interval
+{
+    namespace iv = detail::interval;
+    using Operon::NodeType;
+
+    auto const& nodes = tree.Nodes();
+    if (nodes.empty()) { throw std::runtime_error("Cannot evaluate an empty tree."); }
+    std::vector<Interval> r(nodes.size());
+
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        auto const& n = nodes[i];
+        auto const value = static_cast<double>(n.Value);
+
+        if (n.IsConstant()) {
+            r[i] = { value, value };
+            continue;
+        }
+        if (n.IsVariable()) {
+            auto it = variables.find(n.HashValue);
+            if (it == variables.end()) { throw std::runtime_error("No interval is given for variable " + std::to_string(n.HashValue) + "."); }
+            r[i] = iv::Mul({ value, value }, it->second);
+            continue;
+        }
+
+        // children: the first one is right before the node, then jump over subtrees
+        std::vector<std::size_t> children;
+        children.reserve(n.Arity);
+        for (std::size_t j = i - 1, a = 0; a < n.Arity; ++a) {
+            children.push_back(j);
+            if (a + 1 < n.Arity) { j -= nodes[j].Length + 1; }
+        }
+        if (std::any_of(children.begin(), children.end(), [&](auto c) { return !r[c].IsDefined(); })) {
+            r[i] = iv::Undefined();
+            continue;
+        }
+        auto const& x = r[children.front()];
+
+        auto fold = [&](auto&& op) {
+            auto acc = x;
+            for (std::size_t a = 1; a < children.size(); ++a) { acc = op(acc, r[children[a]]); }
+            return acc;
+        };
+
+        switch (n.Type) {
+        case NodeType::Add: r[i] = fold(iv::Add); break;
+        case NodeType::Mul: r[i] = fold(iv::Mul); break;
+        case NodeType::Sub: r[i] = n.Arity == 1 ? iv::Neg(x) : fold(iv::Sub); break;
+        case NodeType::Div: r[i] = n.Arity == 1 ? iv::Inv(x) : fold(iv::Div); break;
+        case NodeType::Fmin: r[i] = fold([](Interval a, Interval b) { return Interval { std::min(a.Lo, b.Lo), std::min(a.Hi, b.Hi) }; }); break;
+        case NodeType::Fmax: r[i] = fold([](Interval a, Interval b) { return Interval { std::max(a.Lo, b.Lo), std::max(a.Hi, b.Hi) }; }); break;
+        case NodeType::Aq: {
+            // a / sqrt(1 + b^2), the denominator is at least one
+            auto d = iv::Sqrt(iv::Add(iv::Square(r[children[1]]), { 1.0, 1.0 }));
+            r[i] = iv::Div(x, d);
+            break;
+        }
+        case NodeType::Pow: r[i] = iv::Pow(x, r[children[1]]); break;
+        case NodeType::Abs: r[i] = iv::Abs(x); break;
+        case NodeType::Acos: {
+            if (x.Lo < -1 || x.Hi > 1) { r[i] = iv::Undefined(); break; }
+            r[i] = { std::acos(x.Hi), std::acos(x.Lo) };
+            break;
+        }
+        case NodeType::Asin: {
+            if (x.Lo < -1 || x.Hi > 1) { r[i] = iv::Undefined(); break; }
+            r[i] = iv::Increasing(x, [](double v) { return std::asin(v); });
+            break;
+        }
+        case NodeType::Atan: r[i] = iv::Increasing(x, [](double v) { return std::atan(v); }); break;
+        case NodeType::Cbrt: r[i] = iv::Increasing(x, [](double v) { return std::cbrt(v); }); break;
+        case NodeType::Ceil: r[i] = iv::Increasing(x, [](double v) { return std::ceil(v); }); break;
+        case NodeType::Cos: r[i] = iv::Cos(x); break;
+        case NodeType::Cosh: r[i] = iv::Increasing(iv::Abs(x), [](double v) { return std::cosh(v); }); break;
+        case NodeType::Exp: r[i] = iv::Increasing(x, [](double v) { return std::exp(v); }); break;
+        case NodeType::Floor: r[i] = iv::Increasing(x, [](double v) { return std::floor(v); }); break;
+        case NodeType::Log: r[i] = iv::Log(x); break;
+        case NodeType::Logabs: r[i] = iv::Log(iv::Abs(x)); break;
+        case NodeType::Log1p: r[i] = iv::Log(iv::Add(x, { 1.0, 1.0 })); break;
+        case NodeType::Sin: r[i] = iv::Sin(x); break;
+        case NodeType::Sinh: r[i] = iv::Increasing(x, [](double v) { return std::sinh(v); }); break;
+        case NodeType::Sqrt: r[i] = iv::Sqrt(x); break;
+        case NodeType::Sqrtabs: r[i] = iv::Sqrt(iv::Abs(x)); break;
+        case NodeType::Tan: r[i] = iv::Tan(x); break;
+        case NodeType::Tanh: r[i] = iv::Increasing(x, [](double v) { return std::tanh(v); }); break;
+        case NodeType::Square: r[i] = iv::Square(x); break;
+        default: r[i] = iv::Unbounded(); // dynamic primitives carry no bound information
+        }
+        if (std::isnan(r[i].Lo) || std::isnan(r[i].Hi)) { r[i] = iv::Undefined(); }
+    }
+    return r.back();
+}
+
+// per-variable [min, max] over the given rows of a dataset
+inline auto VariableBounds(Operon::Dataset const& ds, Operon::Range range) -> VariableIntervals
+{
+    VariableIntervals bounds;
+    for (auto const& v : ds.Variables()) {
+        auto values = ds.GetValues(v.Hash).subspan(range.Start(), range.Size());
+        if (values.empty()) { continue; }
+        auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+        bounds[v.Hash] = { static_cast<double>(*lo), static_cast<double>(*hi) };
+    }
+    return bounds;
+}
+
+} // namespace pyoperon
+
+#endif
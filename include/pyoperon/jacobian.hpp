@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_JACOBIAN_HPP
+#define PYOPERON_JACOBIAN_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <operon/core/dataset.hpp>
+#include <operon/core/node.hpp>
+#include <operon/core/range.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+#include <operon/interpreter/interpreter.hpp>
+
+namespace pyoperon {
+
+using JacobianMatrix = Eigen::Matrix<Operon::Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// forward-mode jacobian of the tree output with respect to its coefficients
+// (rows x coefficients). the interpreter evaluates the tree with Operon::Dual
+// parameters, seeding Dual::DIMENSION coefficients per pass, so the cost is
+// ceil(coefficients / DIMENSION) vectorized evaluations.
+inline auto EvaluateJacobian(Operon::Interpreter const& interpreter, Operon::Tree const& tree, Operon::Dataset const& ds, Operon::Range range) -> JacobianMatrix
+{
+    using Operon::Dual;
+    constexpr auto dim = static_cast<std::size_t>(Dual::DIMENSION);
+
+    auto const coeff = tree.GetCoefficients();
+    auto const k = coeff.size();
+    auto const rows = range.Size();
+    JacobianMatrix jac(rows, k);
+
+    std::vector<Dual> params(k);
+    for (std::size_t j = 0; j < k; ++j) {
+        params[j].a = coeff[j];
+        params[j].v.setZero();
+    }
+    std::vector<Dual> out(rows);
+
+    for (std::size_t s = 0; s < k; s += dim) {
+        auto const e = std::min(s + dim, k);
+        for (auto j = s; j < e; ++j) { params[j].v[static_cast<Eigen::Index>(j - s)] = 1; }
+        interpreter.Evaluate<Dual>(tree, ds, range, Operon::Span<Dual>(out.data(), out.size()), params.data());
+        for (std::size_t r = 0; r < rows; ++r) {
+            for (auto j = s; j < e; ++j) {
+                jac(static_cast<Eigen::Index>(r), static_cast<Eigen::Index>(j)) = out[r].v[static_cast<Eigen::Index>(j - s)];
+            }
+        }
+        for (auto j = s; j < e; ++j) { params[j].v.setZero(); }
+    }
+    return jac;
+}
+
+// jacobian of the tree output with respect to the input variables given by
+// their hashes (rows x variables). every variable node x (with weight w) is
+// rewritten as w * x + c with a zero offset c: the coefficient jacobian column
+// of c is the derivative with respect to the node value, and summing w times
+// these columns over the nodes of a variable gives its partial derivative.
+// variables that do not occur in the tree get a zero column.
+inline auto EvaluateVariableJacobian(Operon::Interpreter const& interpreter, Operon::Tree const& tree, Operon::Dataset const& ds, Operon::Range range, std::vector<Operon::Hash> const& variables) -> JacobianMatrix
+{
+    std::unordered_map<Operon::Hash, Eigen::Index> columns;
+    for (std::size_t i = 0; i < variables.size(); ++i) { columns.emplace(variables[i], static_cast<Eigen::Index>(i)); }
+
+    // offset coefficient index and weight of every variable node of interest
+    struct Offset {
+        Eigen::Index Coefficient;
+        Eigen::Index Column;
+        Operon::Scalar Weight;
+    };
+    std::vector<Offset> offsets;
+
+    Operon::Vector<Operon::Node> nodes;
+    nodes.reserve(tree.Length() * 3);
+    Eigen::Index coefficient { 0 };
+    for (auto const& n : tree.Nodes()) {
+        auto it = n.IsVariable() ? columns.find(n.HashValue) : columns.end();
+        if (it == columns.end()) {
+            nodes.push_back(n);
+            coefficient += static_cast<Eigen::Index>(n.IsLeaf() && n.Optimize);
+            continue;
+        }
+        // postfix order of the add is offset, variable, add
+        Operon::Node offset(Operon::NodeType::Constant);
+        offset.Value = 0;
+        offset.Optimize = true;
+        offsets.push_back({ coefficient++, it->second, n.Value });
+        nodes.push_back(offset);
+        nodes.push_back(n);
+        coefficient += static_cast<Eigen::Index>(n.Optimize);
+        nodes.push_back(Operon::Node(Operon::NodeType::Add));
+    }
+
+    JacobianMatrix jac = JacobianMatrix::Zero(static_cast<Eigen::Index>(range.Size()), static_cast<Eigen::Index>(variables.size()));
+    if (offsets.empty()) { return jac; }
+
+    Operon::Tree augmented(nodes);
+    augmented.UpdateNodes();
+    auto const full = EvaluateJacobian(interpreter, augmented, ds, range);
+    for (auto const& o : offsets) {
+        jac.col(o.Column) += o.Weight * full.col(o.Coefficient);
+    }
+    return jac;
+}
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_PARALLEL_HPP
+#define PYOPERON_PARALLEL_HPP
+
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <taskflow/taskflow.hpp>
+#if TF_MINOR_VERSION > 2
+#include <taskflow/algorithm/for_each.hpp>
+#endif
+
+namespace pyoperon {
+
+// runs f(i) for i in [0, n) on nthread workers (0 = all cores) and rethrows the
+// first exception raised by any of the calls once all of them have finished
+template<typename F>
+void ParallelFor(std::size_t n, std::size_t nthread, F&& f)
+{
+    if (nthread == 0) { nthread = std::thread::hardware_concurrency(); }
+    std::exception_ptr error;
+    std::mutex mutex;
+    auto body = [&](std::size_t i) {
+        try {
+            f(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) { error = std::current_exception(); }
+        }
+    };
+    if (nthread <= 1 || n < 2) {
+        for (std::size_t i = 0; i < n; ++i) { body(i); }
+    } else {
+        tf::Executor executor(nthread);
+        tf::Taskflow taskflow;
+        taskflow.for_each_index(std::size_t{0}, n, std::size_t{1}, body);
+        executor.run(taskflow).wait();
+    }
+    if (error) { std::rethrow_exception(error); }
+}
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: MIT */
+/* SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research */
+
+#ifndef PYOPERON_PLUGIN_H
+#define PYOPERON_PLUGIN_H
+
+/*
+ * C interface for primitive plugins. a plugin is a shared library compiled
+ * separately from pyoperon which exports
+ *
+ *     PYOPERON_PLUGIN_EXPORT pyoperon_primitive const* pyoperon_primitives(size_t* count);
+ *
+ * returning an array of count primitive descriptions that stays valid for the
+ * lifetime of the process. kernels are vectorized over rows: args[k] points to
+ * n values of the k-th argument and the kernel writes n values to out. the
+ * derivative kernels write the partial derivative with respect to argument
+ * `index`. any kernel except value_f32 may be null; a missing derivative
+ * disables local optimization of trees using the primitive (they keep their
+ * coefficients) and makes EvaluateJacobian raise for them.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PYOPERON_PLUGIN_ABI_VERSION 1
+
+#if defined(_WIN32)
+#define PYOPERON_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define PYOPERON_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*pyoperon_kernel_f32)(float const* const* args, size_t n, float* out);
+typedef void (*pyoperon_kernel_f64)(double const* const* args, size_t n, double* out);
+typedef void (*pyoperon_derivative_f32)(float const* const* args, size_t n, size_t index, float* out);
+typedef void (*pyoperon_derivative_f64)(double const* const* args, size_t n, size_t index, double* out);
+
+typedef struct pyoperon_primitive {
+    uint32_t abi_version; /* PYOPERON_PLUGIN_ABI_VERSION */
+    char const* name;     /* unique name, also used to derive the node hash */
+    uint32_t arity;       /* number of arguments, 1 to PYOPERON_PLUGIN_MAX_ARITY */
+    pyoperon_kernel_f32 value_f32;
+    pyoperon_kernel_f64 value_f64;
+    pyoperon_derivative_f32 derivative_f32;
+    pyoperon_derivative_f64 derivative_f64;
+} pyoperon_primitive;
+
+#define PYOPERON_PLUGIN_MAX_ARITY 8
+
+typedef pyoperon_primitive const* (*pyoperon_primitives_fn)(size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
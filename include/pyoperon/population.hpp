@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_POPULATION_HPP
+#define PYOPERON_POPULATION_HPP
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <operon/core/individual.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+namespace pyoperon {
+
+// structure-of-arrays population storage: the objective values of all
+// individuals are kept in a single row-major (n x m) matrix and the genotypes
+// are concatenated into one node pool indexed by an offset table
+class Population {
+public:
+    using FitnessMatrix = Eigen::Matrix<Operon::Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    Population() = default;
+
+    explicit Population(Operon::Span<Operon::Individual const> individuals)
+    {
+        Assign(individuals);
+    }
+
+    void Assign(Operon::Span<Operon::Individual const> individuals)
+    {
+        auto const n = individuals.size();
+        auto const m = n == 0 ? size_t{0} : individuals.front().Fitness.size();
+
+        offsets_.resize(n + 1);
+        offsets_[0] = 0;
+        for (size_t i = 0; i < n; ++i) {
+            offsets_[i + 1] = offsets_[i] + individuals[i].Genotype.Length();
+        }
+
+        nodes_.clear();
+        nodes_.reserve(offsets_.back());
+        fitness_.resize(static_cast<Eigen::Index>(n), static_cast<Eigen::Index>(m));
+        rank_.resize(n);
+        distance_.resize(n);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto const& ind = individuals[i];
+            if (ind.Fitness.size() != m) {
+                throw std::runtime_error("All individuals must have the same number of objectives.");
+            }
+            auto const& nodes = ind.Genotype.Nodes();
+            nodes_.insert(nodes_.end(), nodes.begin(), nodes.end());
+            std::copy(ind.Fitness.begin(), ind.Fitness.end(), fitness_.row(static_cast<Eigen::Index>(i)).data());
+            rank_[i] = ind.Rank;
+            distance_[i] = ind.Distance;
+        }
+    }
+
+    [[nodiscard]] auto Size() const -> size_t { return rank_.size(); }
+    [[nodiscard]] auto ObjectiveCount() const -> size_t { return static_cast<size_t>(fitness_.cols()); }
+
+    [[nodiscard]] auto Fitness() const -> FitnessMatrix const& { return fitness_; }
+    [[nodiscard]] auto Fitness() -> FitnessMatrix& { return fitness_; }
+
+    [[nodiscard]] auto Fitness(size_t i) const -> Operon::Span<Operon::Scalar const>
+    {
+        return { fitness_.row(static_cast<Eigen::Index>(i)).data(), ObjectiveCount() };
+    }
+
+    [[nodiscard]] auto Nodes() const -> Operon::Span<Operon::Node const> { return { nodes_.data(), nodes_.size() }; }
+    [[nodiscard]] auto Nodes(size_t i) const -> Operon::Span<Operon::Node const>
+    {
+        return { nodes_.data() + offsets_[i], offsets_[i + 1] - offsets_[i] };
+    }
+
+    [[nodiscard]] auto Offsets() const -> Operon::Span<size_t const> { return { offsets_.data(), offsets_.size() }; }
+    [[nodiscard]] auto Rank() const -> Operon::Span<size_t const> { return { rank_.data(), rank_.size() }; }
+    [[nodiscard]] auto Distance() const -> Operon::Span<Operon::Scalar const> { return { distance_.data(), distance_.size() }; }
+
+    [[nodiscard]] auto Genotype(size_t i) const -> Operon::Tree
+    {
+        auto nodes = Nodes(i);
+        return Operon::Tree(Operon::Vector<Operon::Node>(nodes.begin(), nodes.end()));
+    }
+
+    [[nodiscard]] auto operator[](size_t i) const -> Operon::Individual
+    {
+        Operon::Individual ind(ObjectiveCount());
+        ind.Genotype = Genotype(i);
+        auto f = Fitness(i);
+        std::copy(f.begin(), f.end(), ind.Fitness.begin());
+        ind.Rank = rank_[i];
+        ind.Distance = distance_[i];
+        return ind;
+    }
+
+    [[nodiscard]] auto Individuals() const -> std::vector<Operon::Individual>
+    {
+        std::vector<Operon::Individual> individuals;
+        individuals.reserve(Size());
+        for (size_t i = 0; i < Size(); ++i) {
+            individuals.push_back((*this)[i]);
+        }
+        return individuals;
+    }
+
+    // non-dominated sorting over the contiguous fitness matrix: individuals are
+    // visited in lexicographic order, so an individual can only be dominated by
+    // those visited before it and is placed in the first front that contains
+    // no dominating member (efficient non-dominated sort, sequential search).
+    // the lexicographic order does not hold for eps-dominance, with eps > 0
+    // the fronts are peeled off with pairwise comparisons instead
+    auto NondominatedSort(Operon::Scalar eps = 0) -> std::vector<std::vector<size_t>>
+    {
+        auto const n = Size();
+        auto const m = static_cast<Eigen::Index>(ObjectiveCount());
+
+        std::vector<size_t> idx(n);
+        std::iota(idx.begin(), idx.end(), size_t{0});
+        std::stable_sort(idx.begin(), idx.end(), [&](auto a, auto b) {
+            auto ra = fitness_.row(static_cast<Eigen::Index>(a));
+            auto rb = fitness_.row(static_cast<Eigen::Index>(b));
+            return std::lexicographical_compare(ra.data(), ra.data() + m, rb.data(), rb.data() + m);
+        });
+
+        auto dominates = [&](size_t a, size_t b) {
+            auto const* fa = fitness_.row(static_cast<Eigen::Index>(a)).data();
+            auto const* fb = fitness_.row(static_cast<Eigen::Index>(b)).data();
+            bool better { false };
+            for (Eigen::Index k = 0; k < m; ++k) {
+                if (fa[k] > fb[k] + eps) { return false; }
+                better |= fa[k] < fb[k] - eps;
+            }
+            return better;
+        };
+
+        std::vector<std::vector<size_t>> fronts;
+        if (eps > 0) {
+            std::vector<size_t> rest;
+            while (!idx.empty()) {
+                std::vector<size_t> front;
+                rest.clear();
+                for (auto i : idx) {
+                    auto dominated = std::any_of(idx.begin(), idx.end(), [&](auto j) { return dominates(j, i); });
+                    (dominated ? rest : front).push_back(i);
+                }
+                // eps-dominance is not transitive, a cycle goes into one front
+                if (front.empty()) { std::swap(front, rest); }
+                for (auto i : front) { rank_[i] = fronts.size(); }
+                fronts.push_back(std::move(front));
+                std::swap(idx, rest);
+            }
+            return fronts;
+        }
+
+        for (auto i : idx) {
+            auto it = std::find_if(fronts.begin(), fronts.end(), [&](auto const& front) {
+                return std::none_of(front.rbegin(), front.rend(), [&](auto j) { return dominates(j, i); });
+            });
+            if (it == fronts.end()) {
+                it = fronts.insert(fronts.end(), std::vector<size_t>{});
+            }
+            it->push_back(i);
+            rank_[i] = static_cast<size_t>(std::distance(fronts.begin(), it));
+        }
+        return fronts;
+    }
+
+private:
+    FitnessMatrix fitness_;
+    Operon::Vector<Operon::Node> nodes_;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> rank_;
+    std::vector<Operon::Scalar> distance_;
+};
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_PRIMITIVES_HPP
+#define PYOPERON_PRIMITIVES_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <operon/core/node.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+#include "pyoperon/plugin.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace pyoperon {
+
+// user-defined primitive loaded from a plugin library (see plugin.h). nodes
+// using it have type NodeType::Dynamic and Hash as their hash value.
+struct Primitive {
+    std::string Name;
+    std::string Library;
+    Operon::Hash Hash;
+    std::size_t Arity;
+    pyoperon_primitive Kernels;
+
+    [[nodiscard]] auto HasDerivative() const -> bool
+    {
+        return Kernels.derivative_f32 != nullptr || Kernels.derivative_f64 != nullptr;
+    }
+
+    // evaluates the primitive in T, going through the kernel of the other
+    // precision when the plugin does not provide one for T
+    template<typename T>
+    void Evaluate(T const* const* args, std::size_t n, T* out) const
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            Kernels.value_f32(args, n, out); // always present
+        } else {
+            if (Kernels.value_f64 != nullptr) {
+                Kernels.value_f64(args, n, out);
+                return;
+            }
+            Convert(args, n, out, [&](float const* const* a, float* o) { Kernels.value_f32(a, n, o); });
+        }
+    }
+
+    // partial derivative with respect to argument index
+    template<typename T>
+    void Derivative(T const* const* args, std::size_t n, std::size_t index, T* out) const
+    {
+        if (!HasDerivative()) { throw std::runtime_error("Primitive " + Name + " has no derivative."); }
+        if constexpr (std::is_same_v<T, float>) {
+            if (Kernels.derivative_f32 != nullptr) {
+                Kernels.derivative_f32(args, n, index, out);
+                return;
+            }
+            Convert(args, n, out, [&](double const* const* a, double* o) { Kernels.derivative_f64(a, n, index, o); });
+        } else {
+            if (Kernels.derivative_f64 != nullptr) {
+                Kernels.derivative_f64(args, n, index, out);
+                return;
+            }
+            Convert(args, n, out, [&](float const* const* a, float* o) { Kernels.derivative_f32(a, n, index, o); });
+        }
+    }
+
+private:
+    template<typename T, typename F>
+    void Convert(T const* const* args, std::size_t n, T* out, F&& kernel) const
+    {
+        using U = std::conditional_t<std::is_same_v<T, float>, double, float>;
+        std::array<std::vector<U>, PYOPERON_PLUGIN_MAX_ARITY> values;
+        std::array<U const*, PYOPERON_PLUGIN_MAX_ARITY> pointers {};
+        for (std::size_t k = 0; k < Arity; ++k) {
+            values[k].assign(args[k], args[k] + n);
+            pointers[k] = values[k].data();
+        }
+        std::vector<U> result(n);
+        kernel(pointers.data(), result.data());
+        std::copy(result.begin(), result.end(), out);
+    }
+};
+
+// process-wide registry of loaded primitives. plugin libraries are never
+// unloaded since dispatch tables and interpreters keep pointers to their
+// kernels.
+class PrimitiveRegistry {
+public:
+    static auto Instance() -> PrimitiveRegistry&
+    {
+        static PrimitiveRegistry registry;
+        return registry;
+    }
+
+    // hash of a primitive name, salted so that it does not clash with the
+    // hashes of the built-in node types
+    static auto HashName(std::string const& name) -> Operon::Hash
+    {
+        std::uint64_t h { 0xcbf29ce484222325ULL };
+        for (auto c : "pyoperon.primitive." + name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x100000001b3ULL;
+        }
+        return static_cast<Operon::Hash>(h);
+    }
+
+    // loads a plugin library and registers its primitives, returns their names
+    auto Load(std::string const& path) -> std::vector<std::string>
+    {
+        auto* fn = reinterpret_cast<pyoperon_primitives_fn>(Symbol(Open(path), "pyoperon_primitives")); // NOLINT
+        if (fn == nullptr) { throw std::runtime_error(path + " does not export pyoperon_primitives."); }
+
+        std::size_t count { 0 };
+        auto const* primitives = fn(&count);
+        std::vector<std::string> names;
+        for (std::size_t i = 0; i < count; ++i) {
+            Add(primitives[i], path); // NOLINT
+            names.emplace_back(primitives[i].name); // NOLINT
+        }
+        return names;
+    }
+
+    void Add(pyoperon_primitive const& p, std::string const& library)
+    {
+        if (p.abi_version != PYOPERON_PLUGIN_ABI_VERSION) {
+            throw std::runtime_error("Plugin " + library + " was built for a different primitive ABI version.");
+        }
+        if (p.name == nullptr || p.value_f32 == nullptr) {
+            throw std::runtime_error("Plugin " + library + " provides a primitive without name or float kernel.");
+        }
+        if (p.arity == 0 || p.arity > PYOPERON_PLUGIN_MAX_ARITY) {
+            throw std::runtime_error("Primitive " + std::string(p.name) + " has an unsupported arity.");
+        }
+        std::unique_lock lock(mutex_);
+        auto hash = HashName(p.name);
+        if (primitives_.count(hash) != 0) {
+            throw std::runtime_error("A primitive called " + std::string(p.name) + " is already registered.");
+        }
+        primitives_.emplace(hash, Primitive { p.name, library, hash, p.arity, p });
+    }
+
+    [[nodiscard]] auto Find(Operon::Hash hash) const -> Primitive const*
+    {
+        std::shared_lock lock(mutex_);
+        auto it = primitives_.find(hash);
+        return it == primitives_.end() ? nullptr : &it->second;
+    }
+
+    [[nodiscard]] auto Get(std::string const& name) const -> Primitive const&
+    {
+        auto const* p = Find(HashName(name));
+        if (p == nullptr) { throw std::runtime_error("Unknown primitive " + name + "."); }
+        return *p;
+    }
+
+    [[nodiscard]] auto Names() const -> std::vector<std::string>
+    {
+        std::shared_lock lock(mutex_);
+        std::vector<std::string> names;
+        names.reserve(primitives_.size());
+        for (auto const& [hash, p] : primitives_) { names.push_back(p.Name); }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    [[nodiscard]] auto MakeNode(std::string const& name) const -> Operon::Node
+    {
+        auto const& p = Get(name);
+        Operon::Node node(Operon::NodeType::Dynamic, p.Hash);
+        node.Arity = static_cast<decltype(node.Arity)>(p.Arity);
+        return node;
+    }
+
+private:
+    PrimitiveRegistry() = default;
+
+    auto Open(std::string const& path) -> void*
+    {
+#if defined(_WIN32)
+        void* handle = LoadLibraryA(path.c_str());
+#else
+        void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+        if (handle == nullptr) { throw std::runtime_error("Could not load plugin " + path + "."); }
+        std::lock_guard lock(mutex_);
+        handles_.push_back(handle);
+        return handle;
+    }
+
+    static auto Symbol(void* handle, char const* name) -> void*
+    {
+#if defined(_WIN32)
+        return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(handle), name)); // NOLINT
+#else
+        return dlsym(handle, name);
+#endif
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<Operon::Hash, Primitive> primitives_; // node-based, references stay valid
+    std::vector<void*> handles_;
+};
+
+// false if the tree uses a loaded primitive without derivative kernels. local
+// optimization skips such trees, as promised in plugin.h
+inline auto IsDifferentiable(Operon::Tree const& tree) -> bool
+{
+    auto const& registry = PrimitiveRegistry::Instance();
+    auto const& nodes = tree.Nodes();
+    return std::none_of(nodes.begin(), nodes.end(), [&](auto const& n) {
+        if (n.Type != Operon::NodeType::Dynamic) { return false; }
+        auto const* p = registry.Find(n.HashValue);
+        return p != nullptr && !p->HasDerivative();
+    });
+}
+
+namespace detail {
+    // evaluates primitive p for node i of a batch matrix m (columns are node
+    // results, as in Operon::Interpreter). for dual numbers the value part is
+    // computed by the value kernel and the derivative part by the chain rule.
+    template<typename Nodes, typename Matrix>
+    void ApplyPrimitive(Primitive const& p, Nodes const& nodes, Matrix& m, std::size_t i)
+    {
+        using Value = typename std::decay_t<Matrix>::Scalar;
+        auto const rows = static_cast<std::size_t>(m.rows());
+
+        std::array<Eigen::Index, PYOPERON_PLUGIN_MAX_ARITY> children {};
+        auto j = static_cast<Eigen::Index>(i) - 1;
+        for (std::size_t a = 0; a < p.Arity; ++a) {
+            children[a] = j;
+            j -= static_cast<Eigen::Index>(nodes[static_cast<std::size_t>(j)].Length) + 1;
+        }
+        auto const col = static_cast<Eigen::Index>(i);
+
+        if constexpr (std::is_same_v<Value, float> || std::is_same_v<Value, double>) {
+            std::array<Value const*, PYOPERON_PLUGIN_MAX_ARITY> args {};
+            for (std::size_t a = 0; a < p.Arity; ++a) { args[a] = m.col(children[a]).data(); }
+            p.Evaluate(args.data(), rows, m.col(col).data());
+        } else {
+            // dual number with value part a and derivative part v (ceres::Jet)
+            using T = std::decay_t<decltype(std::declval<Value>().a)>;
+            std::array<std::vector<T>, PYOPERON_PLUGIN_MAX_ARITY> values;
+            std::array<T const*, PYOPERON_PLUGIN_MAX_ARITY> args {};
+            for (std::size_t a = 0; a < p.Arity; ++a) {
+                values[a].resize(rows);
+                for (std::size_t r = 0; r < rows; ++r) { values[a][r] = m(static_cast<Eigen::Index>(r), children[a]).a; }
+                args[a] = values[a].data();
+            }
+            std::vector<T> result(rows);
+            std::vector<T> partial(rows);
+            p.Evaluate(args.data(), rows, result.data());
+            for (std::size_t r = 0; r < rows; ++r) {
+                auto& x = m(static_cast<Eigen::Index>(r), col);
+                x.a = result[r];
+                x.v.setZero();
+            }
+            for (std::size_t a = 0; a < p.Arity; ++a) {
+                p.Derivative(args.data(), rows, a, partial.data());
+                for (std::size_t r = 0; r < rows; ++r) {
+                    auto const row = static_cast<Eigen::Index>(r);
+                    m(row, col).v += partial[r] * m(row, children[a]).v;
+                }
+            }
+        }
+    }
+} // namespace detail
+
+// registers a primitive with an Operon::DispatchTable so that the library
+// interpreter (and with it the evaluators and optimizers) can evaluate
+// Dynamic nodes carrying its hash
+template<typename Table>
+void RegisterPrimitive(Table& table, Primitive const& p)
+{
+    table.RegisterCallable(p.Hash, [p](auto const& nodes, auto& m, std::size_t i, auto /*unused*/) {
+        detail::ApplyPrimitive(p, nodes, m, i);
+    });
+}
+
+} // namespace pyoperon
+
+#endif
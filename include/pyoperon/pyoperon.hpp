@@ -14,6 +14,7 @@
 #include <operon/core/types.hpp>
 #include <operon/core/dataset.hpp>
 #include <operon/core/individual.hpp>
+#include <operon/core/node.hpp>
 
 namespace py = pybind11;
 
@@ -31,6 +32,17 @@ auto MakeView(Operon::Span<T const> view) -> py::array_t<T const>
     return arr;
 }
 
+// same as above, but the array holds a reference to base (the owner of the memory)
+template<typename T>
+auto MakeView(Operon::Span<T const> view, py::handle base) -> py::array_t<T const>
+{
+    auto sz = static_cast<pybind11::ssize_t>(view.size());
+    py::array_t<T const> arr(sz, view.data(), base);
+    ENSURE(arr.owndata() == false);
+    ENSURE(arr.data() == view.data());
+    return arr;
+}
+
 template<typename T, int F/*ExtraFlags*/>
 auto MakeSpan(py::array_t<T, F> arr) -> Operon::Span<T>
 {
@@ -38,7 +50,15 @@ auto MakeSpan(py::array_t<T, F> arr) -> Operon::Span<T>
     return Operon::Span<T>(static_cast<T*>(info.ptr), static_cast<typename Operon::Span<T>::size_type>(info.size));
 }
 
+// numpy dtype describing the memory layout of Operon::Node
+auto NodeDtype() -> py::dtype;
+// structured array view of a node sequence, kept alive by base
+auto MakeNodeView(Operon::Span<Operon::Node const> nodes, py::handle base) -> py::array;
+// node vector from a structured array with (at least) the fields Type, Arity, HashValue, Value and IsEnabled
+auto MakeNodes(py::array const& array) -> Operon::Vector<Operon::Node>;
+
 void InitAlgorithm(py::module_&);
+void InitArchive(py::module_&);
 void InitBenchmark(py::module_&);
 void InitCreator(py::module_&);
 void InitCrossover(py::module_&);
@@ -50,6 +70,7 @@ void InitMutation(py::module_&);
 void InitNode(py::module_&);
 void InitNondominatedSorter(py::module_&);
 void InitOptimizer(py::module_&);
+void InitPopulation(py::module_&);
 void InitProblem(py::module_&);
 void InitPset(py::module_&);
 void InitReinserter(py::module_&m);
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_REFIT_HPP
+#define PYOPERON_REFIT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+
+#include <operon/core/range.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+#include "pyoperon/dataset.hpp"
+#include "pyoperon/interpreter.hpp"
+
+namespace pyoperon {
+
+struct RefitResult {
+    std::vector<double> Coefficients; // optimizable leaf values, in tree order
+    double Scale { 1 };
+    double Offset { 0 };
+    double InitialCost { std::numeric_limits<double>::quiet_NaN() }; // mean squared error
+    double FinalCost { std::numeric_limits<double>::quiet_NaN() };
+    std::size_t Iterations { 0 };
+};
+
+namespace detail {
+    inline auto MeanSquaredError(Eigen::ArrayXd const& residual) -> double
+    {
+        return residual.size() == 0 ? 0.0 : residual.square().mean();
+    }
+
+    // closed form least squares fit of target ~ scale * x + offset
+    inline auto FitLinear(Eigen::ArrayXd const& x, Eigen::Map<Eigen::ArrayXd const> const& y) -> std::pair<double, double>
+    {
+        auto const mx = x.mean();
+        auto const my = y.mean();
+        auto const var = (x - mx).square().sum();
+        if (!(var > 0) || !std::isfinite(var)) { return { 0.0, my }; }
+        auto const scale = ((x - mx) * (y - my)).sum() / var;
+        return { scale, my - scale * mx };
+    }
+} // namespace detail
+
+// float64 refit of a tree found by the (float32) search: the coefficients of
+// the tree together with a linear scaling term (scale * f(x) + offset) are
+// tuned by Levenberg-Marquardt with every evaluation done by
+// Interpreter<double> on the float64 values of the dataset. the jacobian is
+// approximated with central differences, which are accurate to about 1e-10
+// in double precision. the tree itself is not modified since its node values
+// are float32; the refitted coefficients are returned instead.
+inline auto Refit(Operon::Tree const& tree, DoubleDataset const& ds, Operon::Span<double const> target, Operon::Range range, std::size_t iterations) -> RefitResult
+{
+    if (target.size() < range.Size()) { throw std::runtime_error("The target is shorter than the range."); }
+
+    Interpreter<double> interpreter;
+    auto const rows = static_cast<Eigen::Index>(range.Size());
+    Eigen::Map<Eigen::ArrayXd const> y(target.data(), rows);
+
+    auto const coeff = tree.GetCoefficients();
+    Eigen::VectorXd theta(static_cast<Eigen::Index>(coeff.size()));
+    std::copy(coeff.begin(), coeff.end(), theta.data());
+
+    Eigen::ArrayXd f(rows);
+    auto evaluate = [&](Eigen::VectorXd const& params, Eigen::ArrayXd& out) {
+        interpreter.Evaluate(tree, ds, range, Operon::Span<double>(out.data(), static_cast<std::size_t>(rows)), params.size() > 0 ? params.data() : nullptr);
+    };
+
+    RefitResult result;
+    evaluate(theta, f);
+    std::tie(result.Scale, result.Offset) = detail::FitLinear(f, y);
+    Eigen::ArrayXd r = result.Scale * f + result.Offset - y;
+    result.InitialCost = detail::MeanSquaredError(r);
+    result.FinalCost = result.InitialCost;
+
+    // parameters are the tree coefficients followed by scale and offset
+    auto const k = theta.size();
+    Eigen::VectorXd p(k + 2);
+    p << theta, result.Scale, result.Offset;
+
+    if (k > 0 && std::isfinite(result.InitialCost)) {
+        Eigen::MatrixXd jac(rows, k + 2);
+        Eigen::ArrayXd fp(rows);
+        Eigen::ArrayXd fm(rows);
+        Eigen::VectorXd q(k);
+        Eigen::ArrayXd rn(rows);
+        auto cost = result.InitialCost;
+        double lambda { 1e-3 };
+        constexpr double lambdaMax { 1e10 };
+        auto const eps = std::cbrt(std::numeric_limits<double>::epsilon());
+        bool converged { false };
+
+        for (std::size_t it = 0; it < iterations && lambda < lambdaMax && !converged; ++it) {
+            theta = p.head(k);
+            auto const scale = p(k);
+            for (Eigen::Index j = 0; j < k; ++j) {
+                auto const h = eps * std::max(std::abs(theta(j)), 1.0);
+                q = theta;
+                q(j) = theta(j) + h;
+                evaluate(q, fp);
+                q(j) = theta(j) - h;
+                evaluate(q, fm);
+                jac.col(j) = (scale * (fp - fm) / (2 * h)).matrix();
+            }
+            jac.col(k) = f.matrix();
+            jac.col(k + 1).setOnes();
+
+            Eigen::MatrixXd const jtj = jac.transpose() * jac;
+            Eigen::VectorXd const jtr = jac.transpose() * r.matrix();
+
+            // increase the damping until the step lowers the cost
+            bool improved { false };
+            while (!improved && lambda < lambdaMax) {
+                Eigen::MatrixXd a = jtj;
+                a.diagonal() += lambda * jtj.diagonal().cwiseMax(1e-12);
+                Eigen::VectorXd const step = a.ldlt().solve(-jtr);
+                Eigen::VectorXd const pn = p + step;
+
+                evaluate(pn.head(k), fp);
+                rn = pn(k) * fp + pn(k + 1) - y;
+                auto const c = detail::MeanSquaredError(rn);
+                if (std::isfinite(c) && c < cost) {
+                    improved = true;
+                    p = pn;
+                    f = fp;
+                    r = rn;
+                    lambda = std::max(lambda / 10, 1e-12);
+                    converged = (cost - c) <= 1e-12 * cost;
+                    cost = c;
+                    ++result.Iterations;
+                } else {
+                    lambda *= 10;
+                }
+            }
+        }
+        result.FinalCost = cost;
+    }
+
+    result.Coefficients.assign(p.data(), p.data() + k);
+    result.Scale = p(k);
+    result.Offset = p(k + 1);
+    return result;
+}
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_SCALING_HPP
+#define PYOPERON_SCALING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <operon/core/dataset.hpp>
+#include <operon/core/range.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+#include <operon/interpreter/interpreter.hpp>
+
+namespace pyoperon {
+
+// streaming least squares fit of target ~ scale * prediction + offset. blocks
+// of predictions are added while they are still in cache: the means and
+// co-moments of each block are computed in double precision and merged into
+// the running totals (Chan et al.), which avoids the cancellation of the
+// plain sums of squares in float32.
+class LinearScaling {
+public:
+    template<typename T, typename U>
+    void Add(T const* prediction, U const* target, std::size_t n)
+    {
+        if (n == 0) { return; }
+        double mx { 0 };
+        double my { 0 };
+        for (std::size_t i = 0; i < n; ++i) {
+            mx += static_cast<double>(prediction[i]);
+            my += static_cast<double>(target[i]);
+        }
+        mx /= static_cast<double>(n);
+        my /= static_cast<double>(n);
+        double sxx { 0 };
+        double sxy { 0 };
+        for (std::size_t i = 0; i < n; ++i) {
+            auto const dx = static_cast<double>(prediction[i]) - mx;
+            sxx += dx * dx;
+            sxy += dx * (static_cast<double>(target[i]) - my);
+        }
+        Merge(static_cast<double>(n), mx, my, sxx, sxy);
+    }
+
+    // adds a block of n rows given its means and co-moments
+    // sxx = sum (x - mx)^2 and sxy = sum (x - mx) (y - my)
+    void Merge(double n, double mx, double my, double sxx, double sxy)
+    {
+        if (!(n > 0)) { return; }
+        auto const total = n_ + n;
+        auto const dx = mx - mx_;
+        auto const dy = my - my_;
+        auto const w = n_ * n / total;
+        sxx_ += sxx + dx * dx * w;
+        sxy_ += sxy + dx * dy * w;
+        mx_ += dx * n / total;
+        my_ += dy * n / total;
+        n_ = total;
+    }
+
+    [[nodiscard]] auto Count() const -> std::size_t { return static_cast<std::size_t>(n_); }
+
+    // a constant (or non-finite) prediction is scaled to the target mean,
+    // as in Refit
+    [[nodiscard]] auto Scale() const -> double
+    {
+        if (!(sxx_ > 0) || !std::isfinite(sxx_)) { return 0.0; }
+        return sxy_ / sxx_;
+    }
+
+    [[nodiscard]] auto Offset() const -> double { return my_ - Scale() * mx_; }
+
+private:
+    double n_ { 0 };
+    double mx_ { 0 };
+    double my_ { 0 };
+    double sxx_ { 0 };
+    double sxy_ { 0 };
+};
+
+// strided view of a (rows x columns) prediction matrix, covers both C and
+// Fortran ordered arrays without copying them
+template<typename T>
+using StridedMatrix = Eigen::Map<Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic> const, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+
+template<typename U>
+using StridedVector = Eigen::Map<Eigen::Array<U, Eigen::Dynamic, 1> const, 0, Eigen::InnerStride<Eigen::Dynamic>>;
+
+// linear scaling (scale, offset) of every column of x against target y in a
+// single pass over x. rows are processed in blocks small enough to stay in
+// cache; each block is converted to double once and its column means and
+// co-moments are computed with vectorized Eigen reductions.
+template<typename T, typename U>
+auto FitLeastSquaresMany(StridedMatrix<T> const& x, StridedVector<U> const& y) -> std::vector<std::pair<double, double>>
+{
+    auto const rows = x.rows();
+    auto const cols = x.cols();
+    std::vector<LinearScaling> scaling(static_cast<std::size_t>(cols));
+
+    // about 256 KiB of doubles per block
+    auto const block = std::max(Eigen::Index { 64 }, Eigen::Index { 32768 } / std::max(cols, Eigen::Index { 1 }));
+    Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic> xb;
+    Eigen::Array<double, Eigen::Dynamic, 1> yb;
+    for (Eigen::Index r = 0; r < rows; r += block) {
+        auto const n = std::min(block, rows - r);
+        xb = x.middleRows(r, n).template cast<double>();
+        yb = y.segment(r, n).template cast<double>();
+        auto const my = yb.mean();
+        yb -= my;
+        Eigen::Array<double, 1, Eigen::Dynamic> mx = xb.colwise().mean();
+        xb.rowwise() -= mx;
+        Eigen::Array<double, 1, Eigen::Dynamic> sxx = xb.square().colwise().sum();
+        Eigen::Array<double, 1, Eigen::Dynamic> sxy = (xb.colwise() * yb).colwise().sum();
+        for (Eigen::Index c = 0; c < cols; ++c) {
+            scaling[static_cast<std::size_t>(c)].Merge(static_cast<double>(n), mx(c), my, sxx(c), sxy(c));
+        }
+    }
+
+    std::vector<std::pair<double, double>> result;
+    result.reserve(scaling.size());
+    for (auto const& s : scaling) { result.emplace_back(s.Scale(), s.Offset()); }
+    return result;
+}
+
+// evaluates the tree into result with the library interpreter block by block,
+// fitting the linear scaling of each block before moving on to the next one.
+// target (float or double) is aligned with range. the prediction is left
+// unscaled.
+template<typename U>
+auto ScaledEvaluate(Operon::Interpreter const& interpreter, Operon::Tree const& tree, Operon::Dataset const& ds, Operon::Range range, Operon::Span<U const> target, Operon::Span<Operon::Scalar> result, std::size_t blockSize = 4096) -> LinearScaling
+{
+    LinearScaling scaling;
+    auto const n = range.Size();
+    for (std::size_t i = 0; i < n; i += blockSize) {
+        auto const m = std::min(blockSize, n - i);
+        auto out = result.subspan(i, m);
+        interpreter.Evaluate(tree, ds, Operon::Range { range.Start() + i, range.Start() + i + m }, out, static_cast<Operon::Scalar*>(nullptr));
+        scaling.Add(out.data(), target.data() + i, m);
+    }
+    return scaling;
+}
+
+} // namespace pyoperon
+
+#endif
@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_SERIALIZE_HPP
+#define PYOPERON_SERIALIZE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <operon/core/node.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+namespace pyoperon::serialize {
+
+// packed binary tree format (all values little-endian):
+//
+//   header (12 bytes)
+//     char[4]  magic "OPTR"
+//     uint16   format version
+//     uint8    size of Operon::Scalar in bytes (4 or 8)
+//     uint8    reserved (zero)
+//     uint32   number of nodes
+//   node records (NodeRecordSize bytes each, in postfix order)
+//     uint32   node type
+//     uint16   arity
+//     uint8    enabled flag
+//     uint8    optimize flag (version 2, reserved and zero in version 1)
+//     uint64   hash value
+//     uint64   calculated hash value
+//     scalar   value (float or double, see header)
+//
+// length, depth, level and parent are not stored since they are recomputed by
+// Tree::UpdateNodes() when the tree is read back. version 1 buffers carry no
+// optimize flag, their nodes keep the default of the Node constructor.
+constexpr std::array<char, 4> Magic { 'O', 'P', 'T', 'R' };
+constexpr std::uint16_t Version { 2 };
+constexpr std::size_t HeaderSize { 12 };
+constexpr std::size_t NodeRecordSize { 24 + sizeof(Operon::Scalar) };
+
+namespace detail {
+    template<typename T>
+    inline auto Store(std::byte* dst, T value) -> std::byte*
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            using U = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            U bits{};
+            std::memcpy(&bits, &value, sizeof(T));
+            return Store(dst, bits);
+        } else {
+            using U = std::make_unsigned_t<T>;
+            auto bits = static_cast<U>(value);
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+                dst[i] = static_cast<std::byte>((bits >> (8U * i)) & U{0xFF}); // NOLINT
+            }
+            return dst + sizeof(T); // NOLINT
+        }
+    }
+
+    template<typename T>
+    inline auto Load(std::byte const* src, T& value) -> std::byte const*
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            using U = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            U bits{};
+            src = Load(src, bits);
+            std::memcpy(&value, &bits, sizeof(T));
+            return src;
+        } else {
+            using U = std::make_unsigned_t<T>;
+            U bits{0};
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+                bits |= static_cast<U>(std::to_integer<U>(src[i]) << (8U * i)); // NOLINT
+            }
+            value = static_cast<T>(bits);
+            return src + sizeof(T); // NOLINT
+        }
+    }
+} // namespace detail
+
+// true if type is exactly one of the node types known to operon
+inline auto IsNodeType(std::uint32_t type) -> bool
+{
+    constexpr auto count = static_cast<std::uint32_t>(Operon::NodeTypes::Count);
+    return type != 0 && (type & (type - 1)) == 0 && type < (std::uint32_t{1} << count);
+}
+
+// checks that decoded nodes (from a buffer or a node array) describe a tree
+// before it is handed to Tree::UpdateNodes(): terminals must be leaves and
+// the arities must form a single tree in postfix order. corrupt input would
+// otherwise lead to out of bounds accesses
+inline void Validate(Operon::Span<Operon::Node const> nodes)
+{
+    std::size_t depth{0};
+    for (auto const& n : nodes) {
+        if (n.Arity != 0 && n.Is<Operon::NodeType::Constant, Operon::NodeType::Variable>()) {
+            throw std::runtime_error("Invalid node sequence: terminal node with arguments.");
+        }
+        if (n.Arity > depth) {
+            throw std::runtime_error("Invalid node sequence: node arity exceeds the number of preceding subtrees.");
+        }
+        depth = depth - n.Arity + 1;
+    }
+    if (!nodes.empty() && depth != 1) {
+        throw std::runtime_error("Invalid node sequence: the nodes do not form a single tree.");
+    }
+}
+
+inline auto SerializedSize(Operon::Tree const& tree) -> std::size_t
+{
+    return HeaderSize + tree.Length() * NodeRecordSize;
+}
+
+// writes the tree to dst, which must hold at least SerializedSize(tree) bytes
+inline auto Write(Operon::Tree const& tree, std::byte* dst) -> std::byte*
+{
+    using detail::Store;
+    std::memcpy(dst, Magic.data(), Magic.size());
+    dst += Magic.size(); // NOLINT
+    dst = Store(dst, Version);
+    dst = Store(dst, static_cast<std::uint8_t>(sizeof(Operon::Scalar)));
+    dst = Store(dst, std::uint8_t{0});
+    dst = Store(dst, static_cast<std::uint32_t>(tree.Length()));
+
+    for (auto const& n : tree.Nodes()) {
+        dst = Store(dst, static_cast<std::uint32_t>(n.Type));
+        dst = Store(dst, static_cast<std::uint16_t>(n.Arity));
+        dst = Store(dst, static_cast<std::uint8_t>(n.IsEnabled));
+        dst = Store(dst, static_cast<std::uint8_t>(n.Optimize));
+        dst = Store(dst, static_cast<std::uint64_t>(n.HashValue));
+        dst = Store(dst, static_cast<std::uint64_t>(n.CalculatedHashValue));
+        dst = Store(dst, n.Value);
+    }
+    return dst;
+}
+
+inline auto ToBytes(Operon::Tree const& tree) -> std::string
+{
+    std::string buf(SerializedSize(tree), '\0');
+    Write(tree, reinterpret_cast<std::byte*>(buf.data())); // NOLINT
+    return buf;
+}
+
+// reads a tree from a buffer of the given size and returns it together with
+// the number of bytes consumed
+inline auto Read(std::byte const* src, std::size_t size) -> std::pair<Operon::Tree, std::size_t>
+{
+    using detail::Load;
+    if (size < HeaderSize || std::memcmp(src, Magic.data(), Magic.size()) != 0) {
+        throw std::runtime_error("Invalid tree buffer: bad header.");
+    }
+    auto const* p = src + Magic.size(); // NOLINT
+    std::uint16_t version{};
+    std::uint8_t scalarSize{};
+    std::uint8_t reserved{};
+    std::uint32_t count{};
+    p = Load(p, version);
+    p = Load(p, scalarSize);
+    p = Load(p, reserved);
+    p = Load(p, count);
+
+    if (version == 0 || version > Version) {
+        throw std::runtime_error("Unsupported tree format version " + std::to_string(version) + ".");
+    }
+    if (scalarSize != 4 && scalarSize != 8) {
+        throw std::runtime_error("Invalid tree buffer: bad scalar size.");
+    }
+    auto const recordSize = NodeRecordSize - sizeof(Operon::Scalar) + scalarSize;
+    auto const total = HeaderSize + std::size_t{count} * recordSize;
+    if (size < total) {
+        throw std::runtime_error("Invalid tree buffer: truncated data.");
+    }
+
+    Operon::Vector<Operon::Node> nodes;
+    nodes.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::uint32_t type{};
+        std::uint16_t arity{};
+        std::uint8_t enabled{};
+        std::uint8_t optimize{};
+        std::uint64_t hash{};
+        std::uint64_t calculatedHash{};
+        p = Load(p, type);
+        p = Load(p, arity);
+        p = Load(p, enabled);
+        p = Load(p, optimize);
+        p = Load(p, hash);
+        p = Load(p, calculatedHash);
+        if (!IsNodeType(type)) {
+            throw std::runtime_error("Invalid tree buffer: unknown node type " + std::to_string(type) + ".");
+        }
+
+        Operon::Node n(static_cast<Operon::NodeType>(type), static_cast<Operon::Hash>(hash));
+        n.Arity = arity;
+        n.IsEnabled = enabled != 0;
+        if (version >= 2) { n.Optimize = optimize != 0; }
+        n.CalculatedHashValue = static_cast<Operon::Hash>(calculatedHash);
+        if (scalarSize == 4) {
+            float v{};
+            p = Load(p, v);
+            n.Value = static_cast<Operon::Scalar>(v);
+        } else {
+            double v{};
+            p = Load(p, v);
+            n.Value = static_cast<Operon::Scalar>(v);
+        }
+        nodes.push_back(n);
+    }
+    Validate({ nodes.data(), nodes.size() });
+    Operon::Tree tree(std::move(nodes));
+    tree.UpdateNodes();
+    return { std::move(tree), total };
+}
+
+inline auto FromBytes(std::string_view bytes) -> Operon::Tree
+{
+    return Read(reinterpret_cast<std::byte const*>(bytes.data()), bytes.size()).first; // NOLINT
+}
+
+} // namespace pyoperon::serialize
+
+#endif
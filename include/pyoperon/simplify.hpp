@@ -0,0 +1,334 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#ifndef PYOPERON_SIMPLIFY_HPP
+#define PYOPERON_SIMPLIFY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <operon/core/node.hpp>
+#include <operon/core/tree.hpp>
+#include <operon/core/types.hpp>
+
+namespace pyoperon {
+
+namespace detail::simplify {
+    // expression tree with the children in operand order (first operand first)
+    struct Expr {
+        Operon::Node Node;
+        std::vector<Expr> Children;
+        std::uint64_t Hash { 0 };
+    };
+
+    inline auto Mix(std::uint64_t h, std::uint64_t v) -> std::uint64_t
+    {
+        h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6U) + (h >> 2U);
+        return h * 0x100000001b3ULL;
+    }
+
+    inline auto Bits(Operon::Scalar value) -> std::uint64_t
+    {
+        auto v = static_cast<double>(value);
+        std::uint64_t bits {};
+        std::memcpy(&bits, &v, sizeof(bits));
+        return bits;
+    }
+
+    inline auto Constant(double value) -> Expr
+    {
+        Expr e { Operon::Node(Operon::NodeType::Constant), {} };
+        e.Node.Value = static_cast<Operon::Scalar>(value);
+        return e;
+    }
+
+    inline auto IsConstant(Expr const& e, double value) -> bool
+    {
+        return e.Node.IsConstant() && static_cast<double>(e.Node.Value) == value;
+    }
+
+    // strict hash of a subtree, including coefficient values. children of
+    // commutative nodes are sorted by hash beforehand, so that equivalent
+    // orderings hash the same
+    inline void UpdateHash(Expr& e)
+    {
+        auto const& n = e.Node;
+        std::uint64_t h { 0xcbf29ce484222325ULL };
+        h = Mix(h, static_cast<std::uint64_t>(n.Type));
+        h = Mix(h, static_cast<std::uint64_t>(e.Children.size()));
+        h = Mix(h, static_cast<std::uint64_t>(n.HashValue));
+        if (n.IsLeaf()) { h = Mix(h, Bits(n.Value)); }
+        for (auto const& c : e.Children) { h = Mix(h, c.Hash); }
+        e.Hash = h;
+    }
+
+    inline void SetChildren(Expr& e, std::vector<Expr> children)
+    {
+        e.Children = std::move(children);
+        e.Node.Arity = static_cast<decltype(e.Node.Arity)>(e.Children.size());
+    }
+
+    // value of a function node applied to constant arguments
+    inline auto Fold(Operon::NodeType type, std::vector<double> const& a) -> std::optional<double>
+    {
+        using Operon::NodeType;
+        auto fold = [&](auto&& op) {
+            auto acc = a.front();
+            for (std::size_t i = 1; i < a.size(); ++i) { acc = op(acc, a[i]); }
+            return acc;
+        };
+        auto const x = a.front();
+        switch (type) {
+        case NodeType::Add: return fold([](double u, double v) { return u + v; });
+        case NodeType::Mul: return fold([](double u, double v) { return u * v; });
+        case NodeType::Sub: return a.size() == 1 ? -x : fold([](double u, double v) { return u - v; });
+        case NodeType::Div: return a.size() == 1 ? 1 / x : fold([](double u, double v) { return u / v; });
+        case NodeType::Fmin: return fold([](double u, double v) { return std::min(u, v); });
+        case NodeType::Fmax: return fold([](double u, double v) { return std::max(u, v); });
+        case NodeType::Aq: return x / std::sqrt(1 + a[1] * a[1]);
+        case NodeType::Pow: return std::pow(x, a[1]);
+        case NodeType::Abs: return std::abs(x);
+        case NodeType::Acos: return std::acos(x);
+        case NodeType::Asin: return std::asin(x);
+        case NodeType::Atan: return std::atan(x);
+        case NodeType::Cbrt: return std::cbrt(x);
+        case NodeType::Ceil: return std::ceil(x);
+        case NodeType::Cos: return std::cos(x);
+        case NodeType::Cosh: return std::cosh(x);
+        case NodeType::Exp: return std::exp(x);
+        case NodeType::Floor: return std::floor(x);
+        case NodeType::Log: return std::log(x);
+        case NodeType::Logabs: return std::log(std::abs(x));
+        case NodeType::Log1p: return std::log1p(x);
+        case NodeType::Sin: return std::sin(x);
+        case NodeType::Sinh: return std::sinh(x);
+        case NodeType::Sqrt: return std::sqrt(x);
+        case NodeType::Sqrtabs: return std::sqrt(std::abs(x));
+        case NodeType::Tan: return std::tan(x);
+        case NodeType::Tanh: return std::tanh(x);
+        case NodeType::Square: return x * x;
+        default: return std::nullopt; // dynamic primitives are left alone
+        }
+    }
+
+    // merges nested nodes of the same commutative type into their parent
+    inline auto Flatten(Operon::NodeType type, std::vector<Expr> children) -> std::vector<Expr>
+    {
+        std::vector<Expr> flat;
+        for (auto& c : children) {
+            if (c.Node.Type == type && c.Node.IsEnabled) {
+                for (auto& g : c.Children) { flat.push_back(std::move(g)); }
+            } else {
+                flat.push_back(std::move(c));
+            }
+        }
+        return flat;
+    }
+
+    inline auto Simplify(Expr e) -> Expr;
+
+    inline auto SimplifyAdd(Expr e) -> Expr
+    {
+        auto children = Flatten(Operon::NodeType::Add, std::move(e.Children));
+        double constant { 0 };
+        bool hasConstant { false };
+        std::vector<Expr> terms;
+        for (auto& c : children) {
+            if (c.Node.IsConstant()) {
+                constant += static_cast<double>(c.Node.Value);
+                hasConstant = true;
+                continue;
+            }
+            // like terms: w1 x + w2 x = (w1 + w2) x
+            if (c.Node.IsVariable()) {
+                auto it = std::find_if(terms.begin(), terms.end(), [&](auto const& t) { return t.Node.IsVariable() && t.Node.HashValue == c.Node.HashValue; });
+                if (it != terms.end()) {
+                    it->Node.Value += c.Node.Value;
+                    UpdateHash(*it);
+                    continue;
+                }
+            }
+            terms.push_back(std::move(c));
+        }
+
+        terms.erase(std::remove_if(terms.begin(), terms.end(), [](auto const& t) { return t.Node.IsVariable() && t.Node.Value == 0; }), terms.end());
+
+        // common subexpressions: s + s + ... = k * s
+        std::vector<Expr> grouped;
+        std::vector<std::size_t> counts;
+        for (auto& t : terms) {
+            auto it = std::find_if(grouped.begin(), grouped.end(), [&](auto const& g) { return g.Hash == t.Hash; });
+            if (it != grouped.end()) {
+                ++counts[static_cast<std::size_t>(it - grouped.begin())];
+                continue;
+            }
+            grouped.push_back(std::move(t));
+            counts.push_back(1);
+        }
+        terms.clear();
+        for (std::size_t i = 0; i < grouped.size(); ++i) {
+            if (counts[i] == 1) {
+                terms.push_back(std::move(grouped[i]));
+                continue;
+            }
+            Expr mul { Operon::Node(Operon::NodeType::Mul), {} };
+            SetChildren(mul, { Constant(static_cast<double>(counts[i])), std::move(grouped[i]) });
+            terms.push_back(Simplify(std::move(mul)));
+        }
+
+        if (hasConstant && (constant != 0 || terms.empty())) { terms.push_back(Constant(constant)); }
+        if (terms.empty()) { return Constant(0); }
+        if (terms.size() == 1) { return std::move(terms.front()); }
+        SetChildren(e, std::move(terms));
+        return e;
+    }
+
+    inline auto SimplifyMul(Expr e) -> Expr
+    {
+        auto children = Flatten(Operon::NodeType::Mul, std::move(e.Children));
+        double constant { 1 };
+        bool hasConstant { false };
+        std::vector<Expr> factors;
+        for (auto& c : children) {
+            if (c.Node.IsConstant()) {
+                constant *= static_cast<double>(c.Node.Value);
+                hasConstant = true;
+                continue;
+            }
+            factors.push_back(std::move(c));
+        }
+        if (hasConstant && constant == 0) { return Constant(0); }
+        if (factors.empty()) { return Constant(hasConstant ? constant : 1); }
+
+        // absorb the constant factor into a variable weight
+        if (hasConstant && constant != 1) {
+            auto it = std::find_if(factors.begin(), factors.end(), [](auto const& f) { return f.Node.IsVariable(); });
+            if (it != factors.end()) {
+                it->Node.Value = static_cast<Operon::Scalar>(static_cast<double>(it->Node.Value) * constant);
+                UpdateHash(*it);
+            } else {
+                factors.push_back(Constant(constant));
+            }
+        }
+        if (factors.size() == 1) { return std::move(factors.front()); }
+        SetChildren(e, std::move(factors));
+        return e;
+    }
+
+    inline auto SimplifyNode(Expr e) -> Expr
+    {
+        using Operon::NodeType;
+        auto& c = e.Children;
+        auto const type = e.Node.Type;
+
+        if (type == NodeType::Add) { return SimplifyAdd(std::move(e)); }
+        if (type == NodeType::Mul) { return SimplifyMul(std::move(e)); }
+
+        // constant folding
+        if (std::all_of(c.begin(), c.end(), [](auto const& x) { return x.Node.IsConstant(); })) {
+            std::vector<double> args;
+            args.reserve(c.size());
+            for (auto const& x : c) { args.push_back(static_cast<double>(x.Node.Value)); }
+            if (auto v = Fold(type, args); v && std::isfinite(*v)) { return Constant(*v); }
+            return e;
+        }
+
+        switch (type) {
+        case NodeType::Sub: {
+            // -(-a) = a
+            if (c.size() == 1 && c[0].Node.Type == NodeType::Sub && c[0].Children.size() == 1) { return std::move(c[0].Children[0]); }
+            if (c.size() == 2) {
+                if (IsConstant(c[1], 0)) { return std::move(c[0]); } // a - 0 = a
+                if (c[0].Hash == c[1].Hash) { return Constant(0); } // a - a = 0
+            }
+            break;
+        }
+        case NodeType::Div: {
+            // 1 / (1 / a) = a
+            if (c.size() == 1 && c[0].Node.Type == NodeType::Div && c[0].Children.size() == 1) { return std::move(c[0].Children[0]); }
+            if (c.size() == 2) {
+                if (IsConstant(c[1], 1)) { return std::move(c[0]); } // a / 1 = a
+                if (c[0].Hash == c[1].Hash) { return Constant(1); } // a / a = 1
+            }
+            break;
+        }
+        case NodeType::Pow: {
+            if (IsConstant(c[1], 1)) { return std::move(c[0]); } // a ^ 1 = a
+            if (IsConstant(c[1], 0)) { return Constant(1); } // a ^ 0 = 1
+            break;
+        }
+        case NodeType::Fmin:
+        case NodeType::Fmax: {
+            if (c.size() == 2 && c[0].Hash == c[1].Hash) { return std::move(c[0]); }
+            break;
+        }
+        default:
+            break;
+        }
+        return e;
+    }
+
+    inline auto Simplify(Expr e) -> Expr
+    {
+        if (e.Node.IsLeaf() || !e.Node.IsEnabled) {
+            UpdateHash(e);
+            return e;
+        }
+        for (auto& c : e.Children) { c = Simplify(std::move(c)); }
+        auto r = SimplifyNode(std::move(e));
+        if (!r.Node.IsLeaf() && (r.Node.IsCommutative())) {
+            std::stable_sort(r.Children.begin(), r.Children.end(), [](auto const& a, auto const& b) { return a.Hash < b.Hash; });
+        }
+        UpdateHash(r);
+        return r;
+    }
+
+    // builds the expression rooted at postfix index i
+    inline auto Build(Operon::Vector<Operon::Node> const& nodes, std::size_t i) -> Expr
+    {
+        Expr e { nodes[i], {} };
+        e.Children.reserve(nodes[i].Arity);
+        for (std::size_t j = i - 1, a = 0; a < nodes[i].Arity; ++a) {
+            e.Children.push_back(Build(nodes, j));
+            if (a + 1 < nodes[i].Arity) { j -= nodes[j].Length + 1; }
+        }
+        return e;
+    }
+
+    // postfix order: the last operand first, so that the first one ends up right before the node
+    inline void Emit(Expr const& e, Operon::Vector<Operon::Node>& nodes)
+    {
+        for (auto it = e.Children.rbegin(); it != e.Children.rend(); ++it) { Emit(*it, nodes); }
+        nodes.push_back(e.Node);
+        nodes.back().CalculatedHashValue = e.Hash;
+    }
+} // namespace detail::simplify
+
+// algebraic simplification: constant folding, identity elimination (a + 0,
+// a * 1, a - a, a / a, a ^ 1, ...), merging of nested sums and products and
+// of like terms, and collapsing of repeated subexpressions in sums (s + s =
+// 2 * s). subexpressions are compared by a strict structural hash (node
+// types, variables and coefficient values), which is written to the
+// CalculatedHashValue of the returned nodes. disabled subtrees are kept as
+// they are.
+inline auto Simplify(Operon::Tree const& tree) -> Operon::Tree
+{
+    auto const& nodes = tree.Nodes();
+    if (nodes.empty()) { return tree; }
+    auto expr = detail::simplify::Simplify(detail::simplify::Build(nodes, nodes.size() - 1));
+    Operon::Vector<Operon::Node> result;
+    result.reserve(nodes.size());
+    detail::simplify::Emit(expr, result);
+    Operon::Tree simplified(result);
+    simplified.UpdateNodes();
+    return simplified;
+}
+
+} // namespace pyoperon
+
+#endif
@@ -1,4 +1,41 @@
 # SPDX-License-Identifier: MIT
 # SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
 
-from .pyoperon import *
+import importlib as _importlib
+import sys as _sys
+
+
+def _load_module():
+    # import the variant of the native module built for the best ISA level
+    # supported by this cpu (if any were built), otherwise the baseline one
+    try:
+        from ._cpuinfo import SupportedIsaLevels
+        levels = SupportedIsaLevels()
+    except ImportError:
+        levels = []
+
+    for level in levels:
+        try:
+            return _importlib.import_module('.pyoperon_' + level.replace('-', '_'), __name__)
+        except ImportError:
+            continue
+    return _importlib.import_module('.pyoperon', __name__)
+
+
+_module = _load_module()
+
+# objects pickled by earlier releases refer to pyoperon.pyoperon. when a variant
+# was loaded, importing the baseline module as well would register every type
+# twice, so the baseline name is made an alias of the loaded variant
+if _module.__name__ != __name__ + '.pyoperon':
+    _sys.modules[__name__ + '.pyoperon'] = _module
+
+for _name, _value in vars(_module).items():
+    if _name.startswith('_'):
+        continue
+    # types from a variant module report its name, pickles should refer to the package
+    if isinstance(_value, type) and _value.__module__ != __name__:
+        _value.__module__ = __name__
+    globals()[_name] = _value
+
+del _name, _value
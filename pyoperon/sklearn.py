@@ -50,6 +50,8 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
         generations                    = 1000,
         max_evaluations                = int(1e6),
         local_iterations               = 0,
+        refit_iterations               = 0,
+        simplify                       = False,
         max_selection_pressure         = 100,
         comparison_factor              = 0,
         brood_size                     = 10,
@@ -83,6 +85,8 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
         self.generations               = generations
         self.max_evaluations           = max_evaluations
         self.local_iterations          = local_iterations
+        self.refit_iterations          = refit_iterations
+        self.simplify                  = simplify
         self.max_selection_pressure    = max_selection_pressure
         self.comparison_factor         = comparison_factor
         self.brood_size                = brood_size
@@ -119,6 +123,8 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
         self.generations                    = check(self.generations, 1000)
         self.max_evaluations                = check(self.max_evaluations, int(1e6))
         self.local_iterations               = check(self.local_iterations, 0)
+        self.refit_iterations               = check(self.refit_iterations, 0)
+        self.simplify                       = check(self.simplify, False)
         self.max_selection_pressure         = check(self.max_selection_pressure, 100)
         self.comparison_factor              = check(self.comparison_factor, 0)
         self.brood_size                     = check(self.brood_size, 10)
@@ -378,6 +384,8 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
             eval_, err_  = self.__init_evaluator(obj, problem, interpreter)
             eval_.Budget = self.max_evaluations
             eval_.LocalOptimizationIterations = self.local_iterations
+            if err_ is not None:
+                eval_.Simplify = self.simplify # simplify offspring before evaluation
             evaluators.append(eval_)
             error_metrics.append(err_)
 
@@ -439,19 +447,34 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
         gp.Run(rng, None, self.n_threads)
 
 
+        # the search runs in float32, the final models are optionally refitted in float64
+        ds64 = op.DoubleDataset(D) if self.refit_iterations > 0 else None
+
         def get_solution_stats(solution):
             """Takes a solution (operon individual) and computes a set of stats"""
             # perform linear scaling
-            y_pred = op.Evaluate(interpreter, solution.Genotype, ds, training_range)
-            scale, offset = op.FitLeastSquares(y_pred, y)
+            if ds64 is None:
+                y_pred, scale, offset = op.ScaledEvaluate(interpreter, solution.Genotype, ds, training_range, y)
+                coefficients = None
+            else:
+                refit = op.Refit(solution.Genotype, ds64, y, training_range, self.refit_iterations)
+                y_pred = op.Interpreter64().Evaluate(solution.Genotype, ds64, training_range, np.asarray(refit.Coefficients))
+                scale, offset = refit.Scale, refit.Offset
+                coefficients = np.asarray(refit.Coefficients + [scale, offset])
             nodes = solution.Genotype.Nodes + [ op.Node.Constant(scale), op.Node.Mul(), op.Node.Constant(offset), op.Node.Add() ]
             solution.Genotype = op.Tree(nodes).UpdateNodes()
+            if coefficients is not None:
+                solution.Genotype.SetCoefficients(coefficients)
+            front_coefficients.append(coefficients)
 
             # get solution variables
             solution_vars = [ds.GetVariable(x.HashValue) for x in solution.Genotype.Nodes if x.IsVariable]
 
-            # get objective values
-            objs = evaluator(rng, solution)
+            # get objective values. the evaluators may simplify or re-optimize the tree they
+            # are given, so they score a copy and the model keeps the nodes and coefficients above
+            scored = op.Individual()
+            scored.Genotype = op.Tree(solution.Genotype)
+            objs = evaluator(rng, scored)
 
             # compute bic
             mse = mean_squared_error(y, y_pred * scale + offset)
@@ -461,9 +484,13 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
 
 
         front = [gp.BestModel] if single_objective else gp.BestFront
+        front_coefficients = []
         self.pareto_front_ = [get_solution_stats(m) for m in front] 
-        tree, tree_vars, objectives, bic = min(self.pareto_front_, key=lambda x: x[3]) # get the model that minimizez the bic
+        best = min(range(len(self.pareto_front_)), key=lambda i: self.pareto_front_[i][3]) # get the model that minimizez the bic
+        tree, tree_vars, objectives, bic = self.pareto_front_[best]
         self.model_ = tree 
+        # float64 coefficients of the selected model (None when not refitted)
+        self.model_coefficients_ = front_coefficients[best]
 
         self.stats_ = {
             'model_length': self.model_.Length - 4, # do not count scaling nodes?
@@ -482,8 +509,11 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
         return self
 
 
-    def evaluate_model(self, model, X):
+    def evaluate_model(self, model, X, coefficients=None):
         X = check_array(X, accept_sparse=False)
+        if coefficients is not None:
+            ds = op.DoubleDataset(X)
+            return op.Interpreter64().Evaluate(model, ds, op.Range(0, ds.Rows), coefficients)
         ds = op.Dataset(X)
         rg = op.Range(0, ds.Rows)
         interpreter = op.Interpreter()
@@ -504,5 +534,7 @@ class SymbolicRegressor(BaseEstimator, RegressorMixin):
             Returns an array of ones.
         """
         check_is_fitted(self)
-        return self.evaluate_model(self.model_, X).reshape(-1, 1)
+        # estimators pickled before float64 refitting have no model_coefficients_
+        coefficients = getattr(self, 'model_coefficients_', None)
+        return self.evaluate_model(self.model_, X, coefficients).reshape(-1, 1)
 
@@ -2,6 +2,8 @@
 // SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
 
 #include "pyoperon/pyoperon.hpp"
+#include "pyoperon/evaluator.hpp"
+#include "pyoperon/population.hpp"
 #include <operon/algorithms/gp.hpp>
 #include <operon/algorithms/nsga2.hpp>
 #include <operon/operators/initializer.hpp>
@@ -10,13 +12,41 @@
 
 #include <pybind11/detail/common.h>
 
+namespace detail {
+    // at every generation boundary the generation clock of the evaluator
+    // driving the algorithm is advanced (mini-batch windows and sampling
+    // schedules), and parents scored on a row sample are re-scored on the
+    // rows of the new generation
+    template<typename Algorithm>
+    auto GenerationCallback(Algorithm& algorithm, std::function<void()> callback, size_t threads) -> std::function<void()>
+    {
+        return [&algorithm, callback = std::move(callback), threads]() {
+            auto const& evaluator = algorithm.GetGenerator().Evaluator();
+            auto const sampled = pyoperon::IsSampling(evaluator);
+            pyoperon::AdvanceGeneration(evaluator);
+            if (sampled) { pyoperon::RescoreSampled(evaluator, algorithm.Parents(), /*full=*/false, threads); }
+            if (callback) { callback(); }
+        };
+    }
+
+    template<typename Algorithm>
+    void Run(Algorithm& algorithm, Operon::RandomGenerator& rng, std::function<void()> callback, size_t threads)
+    {
+        algorithm.Run(rng, GenerationCallback(algorithm, std::move(callback), threads), threads);
+        // the final population is always scored on the full training range
+        auto const& evaluator = algorithm.GetGenerator().Evaluator();
+        if (pyoperon::IsSampling(evaluator)) { pyoperon::RescoreSampled(evaluator, algorithm.Parents(), /*full=*/true, threads); }
+    }
+} // namespace detail
+
 void InitAlgorithm(py::module_ &m)
 {
     py::class_<Operon::GeneticProgrammingAlgorithm>(m, "GeneticProgrammingAlgorithm")
         .def(py::init<Operon::Problem const&, Operon::GeneticAlgorithmConfig const&, Operon::TreeInitializerBase const&,
                 Operon::CoefficientInitializerBase const&, Operon::OffspringGeneratorBase const&, Operon::ReinserterBase const&>())
-        .def("Run", py::overload_cast<Operon::RandomGenerator&, std::function<void()>, size_t>(&Operon::GeneticProgrammingAlgorithm::Run),
-                py::call_guard<py::gil_scoped_release>(), py::arg("rng"), py::arg("callback") = nullptr, py::arg("threads") = 0)
+        .def("Run", [](Operon::GeneticProgrammingAlgorithm& self, Operon::RandomGenerator& rng, std::function<void()> callback, size_t threads) {
+                detail::Run(self, rng, std::move(callback), threads);
+            }, py::call_guard<py::gil_scoped_release>(), py::arg("rng"), py::arg("callback") = nullptr, py::arg("threads") = 0)
         .def("Reset", &Operon::GeneticProgrammingAlgorithm::Reset)
         .def_property_readonly("BestModel", [](Operon::GeneticProgrammingAlgorithm const& self) {
                 auto minElem = std::min_element(self.Parents().begin(), self.Parents().end(), [&](auto const& a, auto const& b) { return a[0] < b[0]; });
@@ -24,13 +54,17 @@ void InitAlgorithm(py::module_ &m)
             })
         .def_property_readonly("Generation", &Operon::GeneticProgrammingAlgorithm::Generation)
         .def_property_readonly("Individuals", &Operon::GeneticProgrammingAlgorithm::Individuals)
+        .def_property_readonly("Population", [](Operon::GeneticProgrammingAlgorithm const& self) {
+                return pyoperon::Population(self.Individuals());
+            })
         .def_property_readonly("Config", &Operon::GeneticProgrammingAlgorithm::GetConfig);
 
     py::class_<Operon::NSGA2>(m, "NSGA2Algorithm")
         .def(py::init<Operon::Problem const&, Operon::GeneticAlgorithmConfig const&, Operon::TreeInitializerBase const&, Operon::CoefficientInitializerBase const&,
                 Operon::OffspringGeneratorBase const&, Operon::ReinserterBase const&, Operon::NondominatedSorterBase const&>())
-        .def("Run", py::overload_cast<Operon::RandomGenerator&, std::function<void()>, size_t>(&Operon::NSGA2::Run),
-                py::call_guard<py::gil_scoped_release>(), py::arg("rng"), py::arg("callback") = nullptr, py::arg("threads") = 0)
+        .def("Run", [](Operon::NSGA2& self, Operon::RandomGenerator& rng, std::function<void()> callback, size_t threads) {
+                detail::Run(self, rng, std::move(callback), threads);
+            }, py::call_guard<py::gil_scoped_release>(), py::arg("rng"), py::arg("callback") = nullptr, py::arg("threads") = 0)
         .def("Reset", &Operon::NSGA2::Reset)
         .def_property_readonly("BestModel", [](Operon::NSGA2 const& self) {
                 auto minElem = std::min_element(self.Best().begin(), self.Best().end(), [&](auto const& a, auto const& b) { return a[0] < b[0];});
@@ -38,6 +72,9 @@ void InitAlgorithm(py::module_ &m)
             })
         .def_property_readonly("Generation", &Operon::NSGA2::Generation)
         .def_property_readonly("Individuals", &Operon::NSGA2::Individuals)
+        .def_property_readonly("Population", [](Operon::NSGA2 const& self) {
+                return pyoperon::Population(self.Individuals());
+            })
         .def_property_readonly("BestFront", [](Operon::NSGA2 const& self) {
                     auto best = self.Best();
                     return std::vector<Operon::Individual>(best.begin(), best.end());
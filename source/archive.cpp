@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#include <algorithm>
+
+#include <operon/core/dataset.hpp>
+#include <operon/operators/evaluator.hpp>
+
+#include "pyoperon/archive.hpp"
+#include "pyoperon/pyoperon.hpp"
+
+namespace py = pybind11;
+
+void InitArchive(py::module_ &m)
+{
+    using Archive = pyoperon::Archive;
+
+    py::class_<Archive>(m, "PopulationArchive")
+        .def(py::init<std::string, size_t>(), py::arg("path"), py::arg("objectives") = 0)
+        .def("__len__", &Archive::Size)
+        .def("__getitem__", [](Archive const& self, size_t i) {
+            if (i >= self.Size()) { throw py::index_error(); }
+            return self[i];
+        })
+        .def("Append", py::overload_cast<Operon::Individual const&>(&Archive::Append), py::arg("individual"))
+        .def("Append", [](Archive& self, std::vector<Operon::Individual> const& individuals) {
+            self.Append(Operon::Span<Operon::Individual const>(individuals.data(), individuals.size()));
+        }, py::arg("individuals"))
+        .def("Tree", &Archive::Tree, py::arg("index"))
+        .def("Fitness", [](Archive const& self, size_t i) {
+            auto fitness = self.Fitness(i);
+            py::array_t<Operon::Scalar> result(static_cast<py::ssize_t>(fitness.size()));
+            std::copy(fitness.begin(), fitness.end(), result.mutable_data());
+            return result;
+        }, py::arg("index"))
+        .def("Trees", &Archive::Trees, py::arg("begin"), py::arg("end"), py::call_guard<py::gil_scoped_release>())
+        .def("Individuals", [](Archive const& self, size_t begin, size_t end) {
+            std::vector<Operon::Individual> individuals;
+            for (auto i = begin; i < std::min(end, self.Size()); ++i) { individuals.push_back(self[i]); }
+            return individuals;
+        }, py::arg("begin"), py::arg("end"))
+        .def_property_readonly("Path", &Archive::Path)
+        .def_property_readonly("ObjectiveCount", &Archive::ObjectiveCount)
+        .def_property_readonly("Size", &Archive::Size);
+
+    // evaluate trees streamed from the mapped archive in batches, so that only
+    // batch_size decoded trees are held in memory at any time
+    m.def("EvaluateTrees", [](Archive const& archive, Operon::Dataset const& ds, Operon::Range range, py::array_t<Operon::Scalar> result, size_t nthread, size_t batchSize) {
+            auto span = MakeSpan(result);
+            if (span.size() < archive.Size() * range.Size()) {
+                throw std::runtime_error("The result buffer is too small.");
+            }
+            py::gil_scoped_release release;
+            batchSize = std::max(batchSize, size_t{1});
+            for (size_t i = 0; i < archive.Size(); i += batchSize) {
+                auto trees = archive.Trees(i, i + batchSize);
+                Operon::EvaluateTrees(trees, ds, range, span.subspan(i * range.Size(), trees.size() * range.Size()), nthread);
+            }
+            py::gil_scoped_acquire acquire;
+            }, py::arg("archive"), py::arg("dataset"), py::arg("range"), py::arg("result").noconvert(), py::arg("nthread") = 1, py::arg("batch_size") = 1024);
+}
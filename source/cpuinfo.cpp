@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+// small helper module queried by the python package before it decides which
+// ISA variant of the main module to import. it must not register any operon
+// types, since only one variant of the main module can be loaded at a time.
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "pyoperon/cpu.hpp"
+
+PYBIND11_MODULE(_cpuinfo, m)
+{
+    m.def("SupportedIsaLevels", &pyoperon::SupportedIsaLevels);
+}
@@ -10,6 +10,7 @@
 #include <operon/core/dataset.hpp>
 #include <utility>
 
+#include "pyoperon/dataset.hpp"
 #include "pyoperon/pyoperon.hpp"
 
 namespace py = pybind11;
@@ -103,4 +104,21 @@ void InitDataset(py::module_ &m)
         .def("Normalize", &Operon::Dataset::Normalize)
         .def("Standardize", &Operon::Dataset::Standardize)
         ;
+
+    // float64 dataset, always copies the data
+    py::class_<pyoperon::DoubleDataset>(m, "DoubleDataset")
+        .def(py::init([](py::array_t<double, py::array::f_style | py::array::forcecast> array) {
+            if (array.ndim() != 2) {
+                throw std::runtime_error("The input array must have exactly two dimensions.\n");
+            }
+            return pyoperon::DoubleDataset(array.cast<pyoperon::DoubleDataset::Matrix>());
+        }), py::arg("data"))
+        .def_property_readonly("Rows", &pyoperon::DoubleDataset::Rows)
+        .def_property_readonly("Cols", &pyoperon::DoubleDataset::Cols)
+        .def_property_readonly("Values", &pyoperon::DoubleDataset::Values, py::return_value_policy::reference_internal)
+        .def_property_readonly("Dataset", &pyoperon::DoubleDataset::Dataset, py::return_value_policy::reference_internal)
+        .def_property("VariableNames", &pyoperon::DoubleDataset::VariableNames, &pyoperon::DoubleDataset::SetVariableNames)
+        .def("GetValues", [](pyoperon::DoubleDataset const& self, std::string const& name) { return MakeView(self.GetValues(name)); })
+        .def("GetValues", [](pyoperon::DoubleDataset const& self, Operon::Hash hash) { return MakeView(self.GetValues(hash)); })
+        .def("GetValues", [](pyoperon::DoubleDataset const& self, int index) { return MakeView(self.GetValues(index)); });
 }
@@ -5,8 +5,20 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <optional>
+
 #include <operon/operators/evaluator.hpp>
+#include "pyoperon/arena.hpp"
+#include "pyoperon/batch_evaluator.hpp"
+#include "pyoperon/dataset.hpp"
+#include "pyoperon/evaluator.hpp"
+#include "pyoperon/interpreter.hpp"
+#include "pyoperon/interval.hpp"
+#include "pyoperon/jacobian.hpp"
+#include "pyoperon/parallel.hpp"
+#include "pyoperon/primitives.hpp"
 #include "pyoperon/pyoperon.hpp"
+#include "pyoperon/scaling.hpp"
 
 namespace py = pybind11;
 
@@ -18,6 +30,149 @@ namespace detail {
         auto s2 = MakeSpan(rhs);
         return Operon::FitLeastSquares(s1, s2);
     }
+
+    // calls f(array, T{}) with T the element type of a float32 or float64 array,
+    // which is then accessed in place. other dtypes are converted to float64
+    template<typename F>
+    auto VisitFloating(py::array const& a, F&& f)
+    {
+        if (py::isinstance<py::array_t<float>>(a)) { return f(a, float{}); }
+        if (py::isinstance<py::array_t<double>>(a)) { return f(a, double{}); }
+        auto converted = py::array_t<double, py::array::forcecast>::ensure(a);
+        if (!converted) { throw std::runtime_error("Expected a numeric array."); }
+        return f(converted, double{});
+    }
+
+    // calls f(Operon::Span<U const>) with a one dimensional float32 or float64
+    // target read in place (only non-contiguous arrays are copied)
+    template<typename F>
+    auto VisitTarget(py::array const& target, F&& f)
+    {
+        if (target.ndim() != 1) { throw std::runtime_error("Expected a one dimensional target."); }
+        return VisitFloating(target, [&](py::array const& a, auto u) {
+            using U = decltype(u);
+            auto y = py::array_t<U, py::array::c_style | py::array::forcecast>::ensure(a);
+            return f(Operon::Span<U const>(y.data(), static_cast<size_t>(y.size())));
+        });
+    }
+
+    // strided views over numpy buffers (strides are in bytes)
+    template<typename T>
+    auto MatrixView(py::array const& a) -> pyoperon::StridedMatrix<T>
+    {
+        auto const sz = static_cast<pybind11::ssize_t>(sizeof(T));
+        auto const rows = a.shape(0);
+        auto const cols = a.ndim() == 2 ? a.shape(1) : pybind11::ssize_t{1};
+        auto const inner = a.strides(0) / sz;
+        auto const outer = a.ndim() == 2 ? a.strides(1) / sz : rows * inner;
+        return { static_cast<T const*>(a.data()), rows, cols, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(outer, inner) };
+    }
+
+    template<typename T>
+    auto VectorView(py::array const& a) -> pyoperon::StridedVector<T>
+    {
+        auto const sz = static_cast<pybind11::ssize_t>(sizeof(T));
+        return { static_cast<T const*>(a.data()), a.shape(0), Eigen::InnerStride<Eigen::Dynamic>(a.strides(0) / sz) };
+    }
+
+    // linear scaling of every column of prediction against target, for any
+    // combination of float32 and float64 arrays
+    auto FitLeastSquaresMany(py::array const& prediction, py::array const& target) -> std::vector<std::pair<double, double>>
+    {
+        if (prediction.ndim() < 1 || prediction.ndim() > 2 || target.ndim() != 1) {
+            throw std::runtime_error("Expected a one or two dimensional prediction and a one dimensional target.");
+        }
+        if (prediction.shape(0) != target.shape(0)) { throw std::runtime_error("The prediction and the target have a different number of rows."); }
+        return VisitFloating(prediction, [&](py::array const& x, auto t) {
+            return VisitFloating(target, [&](py::array const& y, auto u) {
+                auto xv = MatrixView<decltype(t)>(x);
+                auto yv = VectorView<decltype(u)>(y);
+                py::gil_scoped_release release;
+                return pyoperon::FitLeastSquaresMany(xv, yv);
+            });
+        });
+    }
+
+    // evaluate with a precision-templated interpreter, optionally overriding the leaf coefficients
+    template<typename T, typename Data>
+    auto Evaluate(pyoperon::Interpreter<T> const& interpreter, Operon::Tree const& tree, Data const& data, Operon::Range range, std::optional<py::array_t<T, py::array::c_style | py::array::forcecast>> coefficients) -> py::array_t<T>
+    {
+        T const* coeff { nullptr };
+        if (coefficients) {
+            if (static_cast<size_t>(coefficients->size()) != tree.CoefficientsCount()) {
+                throw std::runtime_error("The number of coefficients does not match the tree.");
+            }
+            coeff = coefficients->data();
+        }
+        auto result = py::array_t<T>(static_cast<pybind11::ssize_t>(range.Size()));
+        auto span = MakeSpan(result);
+        py::gil_scoped_release release;
+        interpreter.Evaluate(tree, data, range, span, coeff);
+        py::gil_scoped_acquire acquire;
+        return result;
+    }
+
+    // evaluate and fit the linear scaling in the same pass, returns (prediction, scale, offset)
+    template<typename T, typename Data>
+    auto ScaledEvaluate(pyoperon::Interpreter<T> const& interpreter, Operon::Tree const& tree, Data const& data, Operon::Range range, py::array const& target, std::optional<py::array_t<T, py::array::c_style | py::array::forcecast>> coefficients) -> py::tuple
+    {
+        T const* coeff { nullptr };
+        if (coefficients) {
+            if (static_cast<size_t>(coefficients->size()) != tree.CoefficientsCount()) {
+                throw std::runtime_error("The number of coefficients does not match the tree.");
+            }
+            coeff = coefficients->data();
+        }
+        auto result = py::array_t<T>(static_cast<pybind11::ssize_t>(range.Size()));
+        auto span = MakeSpan(result);
+        auto scaling = VisitTarget(target, [&](auto y) {
+            py::gil_scoped_release release;
+            return interpreter.ScaledEvaluate(tree, data, range, y, span, coeff);
+        });
+        return py::make_tuple(result, scaling.Scale(), scaling.Offset());
+    }
+
+    // python passes intervals as {hash: (lo, hi)}
+    using IntervalMap = std::unordered_map<Operon::Hash, std::pair<double, double>>;
+
+    auto ToIntervals(IntervalMap const& map) -> pyoperon::VariableIntervals
+    {
+        pyoperon::VariableIntervals intervals;
+        for (auto const& [hash, bounds] : map) {
+            if (!(bounds.first <= bounds.second)) { throw std::invalid_argument("Invalid interval for variable " + std::to_string(hash) + "."); }
+            intervals[hash] = { bounds.first, bounds.second };
+        }
+        return intervals;
+    }
+
+    auto FromIntervals(pyoperon::VariableIntervals const& intervals) -> IntervalMap
+    {
+        IntervalMap map;
+        for (auto const& [hash, interval] : intervals) { map[hash] = { interval.Lo, interval.Hi }; }
+        return map;
+    }
+
+    template<typename T>
+    void BindInterpreter(py::module_& m, char const* name)
+    {
+        using Interpreter = pyoperon::Interpreter<T>;
+        using Coefficients = std::optional<py::array_t<T, py::array::c_style | py::array::forcecast>>;
+        using Target = py::array const&;
+        py::class_<Interpreter>(m, name)
+            .def(py::init<>())
+            .def("Evaluate", [](Interpreter const& self, Operon::Tree const& tree, Operon::Dataset const& ds, Operon::Range range, Coefficients coefficients) {
+                return Evaluate(self, tree, ds, range, std::move(coefficients));
+            }, py::arg("tree"), py::arg("dataset"), py::arg("range"), py::arg("coefficients") = py::none())
+            .def("Evaluate", [](Interpreter const& self, Operon::Tree const& tree, pyoperon::DoubleDataset const& ds, Operon::Range range, Coefficients coefficients) {
+                return Evaluate(self, tree, ds, range, std::move(coefficients));
+            }, py::arg("tree"), py::arg("dataset"), py::arg("range"), py::arg("coefficients") = py::none())
+            .def("ScaledEvaluate", [](Interpreter const& self, Operon::Tree const& tree, Operon::Dataset const& ds, Operon::Range range, Target target, Coefficients coefficients) {
+                return ScaledEvaluate(self, tree, ds, range, target, std::move(coefficients));
+            }, py::arg("tree"), py::arg("dataset"), py::arg("range"), py::arg("target"), py::arg("coefficients") = py::none())
+            .def("ScaledEvaluate", [](Interpreter const& self, Operon::Tree const& tree, pyoperon::DoubleDataset const& ds, Operon::Range range, Target target, Coefficients coefficients) {
+                return ScaledEvaluate(self, tree, ds, range, target, std::move(coefficients));
+            }, py::arg("tree"), py::arg("dataset"), py::arg("range"), py::arg("target"), py::arg("coefficients") = py::none());
+    }
 } // namespace detail
 
 void InitEval(py::module_ &m)
@@ -33,6 +188,53 @@ void InitEval(py::module_ &m)
         return result;
         }, py::arg("interpreter"), py::arg("tree"), py::arg("dataset"), py::arg("range"));
 
+    // evaluate and fit target ~ scale * prediction + offset without a second pass over the
+    // prediction. float32 and float64 targets are read in place
+    m.def("ScaledEvaluate", [](Operon::Interpreter const& i, Operon::Tree const& t, Operon::Dataset const& d, Operon::Range r, py::array const& target) {
+        auto result = py::array_t<Operon::Scalar>(static_cast<pybind11::ssize_t>(r.Size()));
+        auto span = MakeSpan(result);
+        auto scaling = detail::VisitTarget(target, [&](auto y) {
+            if (y.size() < r.Size()) { throw std::runtime_error("The target is shorter than the range."); }
+            py::gil_scoped_release release;
+            return pyoperon::ScaledEvaluate(i, t, d, r, y.subspan(0, r.Size()), span);
+        });
+        return py::make_tuple(result, scaling.Scale(), scaling.Offset());
+        }, py::arg("interpreter"), py::arg("tree"), py::arg("dataset"), py::arg("range"), py::arg("target"));
+
+    // interval arithmetic: output bounds of trees for given input bounds, without data
+    m.def("VariableBounds", [](Operon::Dataset const& ds, Operon::Range range) {
+        return detail::FromIntervals(pyoperon::VariableBounds(ds, range));
+    }, py::arg("dataset"), py::arg("range"));
+
+    m.def("EvaluateInterval", [](Operon::Tree const& tree, detail::IntervalMap const& bounds) {
+        auto r = pyoperon::EvaluateInterval(tree, detail::ToIntervals(bounds));
+        return std::make_pair(r.Lo, r.Hi);
+    }, py::arg("tree"), py::arg("bounds"));
+
+    // returns an (n x 2) array of [lo, hi] rows
+    m.def("EvaluateIntervals", [](std::vector<Operon::Tree> const& trees, detail::IntervalMap const& bounds, size_t nthread) {
+        auto intervals = detail::ToIntervals(bounds);
+        py::array_t<double> result({ trees.size(), size_t{2} });
+        auto* data = result.mutable_data();
+        py::gil_scoped_release release;
+        pyoperon::ParallelFor(trees.size(), nthread, [&](size_t i) {
+            auto r = pyoperon::EvaluateInterval(trees[i], intervals);
+            data[2 * i] = r.Lo;
+            data[2 * i + 1] = r.Hi;
+        });
+        py::gil_scoped_acquire acquire;
+        return result;
+    }, py::arg("trees"), py::arg("bounds"), py::arg("nthread") = 0);
+
+    // forward-mode jacobians computed with the dual number kernels of the interpreter
+    m.def("EvaluateJacobian", [](Operon::Interpreter const& i, Operon::Tree const& t, Operon::Dataset const& d, Operon::Range r) {
+        return pyoperon::EvaluateJacobian(i, t, d, r);
+        }, py::arg("interpreter"), py::arg("tree"), py::arg("dataset"), py::arg("range"), py::call_guard<py::gil_scoped_release>());
+
+    m.def("EvaluateVariableJacobian", [](Operon::Interpreter const& i, Operon::Tree const& t, Operon::Dataset const& d, Operon::Range r, std::vector<Operon::Hash> const& variables) {
+        return pyoperon::EvaluateVariableJacobian(i, t, d, r, variables);
+        }, py::arg("interpreter"), py::arg("tree"), py::arg("dataset"), py::arg("range"), py::arg("variables"), py::call_guard<py::gil_scoped_release>());
+
     m.def("EvaluateTrees", [](std::vector<Operon::Tree> const& trees, Operon::Dataset const& ds, Operon::Range range, py::array_t<Operon::Scalar> result, size_t nthread) {
             auto span = MakeSpan(result);
             py::gil_scoped_release release;
@@ -68,10 +270,15 @@ void InitEval(py::module_ &m)
         auto buf = result.request();
         auto values = d.GetValues(target).subspan(r.Start(), r.Size());
 
+        // reuse a single scratch buffer for all trees
+        pyoperon::ArenaScope scope;
+        pyoperon::ArenaVector<Operon::Scalar> estimated(r.Size());
+        Operon::Span<Operon::Scalar> span(estimated.data(), estimated.size());
+
         // TODO: make this run in parallel with taskflow
         std::transform(trees.begin(), trees.end(), static_cast<double*>(buf.ptr), [&](auto const& t) -> double {
-            auto estimated = i.Evaluate(t, d, r, static_cast<Operon::Scalar*>(nullptr));
-            return (*error)(estimated, values);
+            i.Evaluate(t, d, r, span, static_cast<Operon::Scalar*>(nullptr));
+            return (*error)(span, values);
         });
 
         return result;
@@ -86,11 +293,45 @@ void InitEval(py::module_ &m)
         return detail::FitLeastSquares<double>(lhs, rhs);
     });
 
+    // mixed float32/float64 pairs, fitted in place without converting either array
+    m.def("FitLeastSquares", [](py::array const& lhs, py::array const& rhs) -> std::pair<double, double> {
+        if (lhs.ndim() != 1) { throw std::runtime_error("Expected a one dimensional prediction."); }
+        return detail::FitLeastSquaresMany(lhs, rhs).front();
+    });
+
+    // scale and offset of every column of a (rows x k) prediction matrix, returned as a (k x 2) array
+    m.def("FitLeastSquaresMany", [](py::array const& prediction, py::array const& target) {
+        auto fits = detail::FitLeastSquaresMany(prediction, target);
+        py::array_t<double> result({ fits.size(), size_t{2} });
+        auto* data = result.mutable_data();
+        for (size_t i = 0; i < fits.size(); ++i) {
+            data[2 * i] = fits[i].first;
+            data[2 * i + 1] = fits[i].second;
+        }
+        return result;
+    }, py::arg("prediction"), py::arg("target"));
+
+    // precision-templated interpreters: float32 for speed, float64 for accuracy
+    detail::BindInterpreter<float>(m, "Interpreter32");
+    detail::BindInterpreter<double>(m, "Interpreter64");
+
     using DispatchTable = Operon::DispatchTable<Operon::Scalar, Operon::Dual>;
 
-    // dispatch table
+    // plugin primitives, evaluated for Dyn nodes carrying their hash
+    m.def("LoadPrimitives", [](std::string const& path) { return pyoperon::PrimitiveRegistry::Instance().Load(path); }, py::arg("path"));
+    m.def("Primitives", []() { return pyoperon::PrimitiveRegistry::Instance().Names(); });
+    m.def("PrimitiveHash", &pyoperon::PrimitiveRegistry::HashName, py::arg("name"));
+
+    // dispatch table, primitives must be registered before the table is passed to an interpreter (which copies it)
     py::class_<DispatchTable>(m, "DispatchTable")
-        .def(py::init<>());
+        .def(py::init<>())
+        .def("RegisterPrimitive", [](DispatchTable& self, std::string const& name) {
+            pyoperon::RegisterPrimitive(self, pyoperon::PrimitiveRegistry::Instance().Get(name));
+        }, py::arg("name"))
+        .def("RegisterPrimitives", [](DispatchTable& self) {
+            auto const& registry = pyoperon::PrimitiveRegistry::Instance();
+            for (auto const& name : registry.Names()) { pyoperon::RegisterPrimitive(self, registry.Get(name)); }
+        });
 
     // interpreter
     py::class_<Operon::Interpreter>(m, "Interpreter")
@@ -121,12 +362,86 @@ void InitEval(py::module_ &m)
         .def_property_readonly("ResidualEvaluations", [](Operon::EvaluatorBase& self) { return self.ResidualEvaluations.load(); })
         .def_property_readonly("JacobianEvaluations", [](Operon::EvaluatorBase& self) { return self.JacobianEvaluations.load(); });
 
-    py::class_<Operon::Evaluator, Operon::EvaluatorBase>(m, "Evaluator")
-        .def(py::init<Operon::Problem&, Operon::Interpreter&, Operon::ErrorMetric const&, bool>());
+    py::enum_<pyoperon::SolverType>(m, "SolverType")
+        .value("Auto", pyoperon::SolverType::Auto)
+        .value("Eigen", pyoperon::SolverType::Eigen)
+        .value("Tiny", pyoperon::SolverType::Tiny)
+        .value("Ceres", pyoperon::SolverType::Ceres);
+
+    m.def("CeresAvailable", &pyoperon::CeresAvailable);
+    m.def("SelectSolver", &pyoperon::SelectSolver, py::arg("coefficients"), py::arg("rows"));
+
+    py::class_<pyoperon::CoefficientCache>(m, "CoefficientCache")
+        .def(py::init<size_t>(), py::arg("capacity") = 100'000)
+        .def("Clear", &pyoperon::CoefficientCache::Clear)
+        .def("__len__", &pyoperon::CoefficientCache::Size)
+        .def_property_readonly("Size", &pyoperon::CoefficientCache::Size)
+        .def_property_readonly("Capacity", &pyoperon::CoefficientCache::Capacity)
+        .def_property_readonly("Hits", &pyoperon::CoefficientCache::Hits)
+        .def_property_readonly("Misses", &pyoperon::CoefficientCache::Misses);
+
+    py::class_<pyoperon::FitnessMemo>(m, "FitnessMemo")
+        .def(py::init<size_t, size_t>(), py::arg("capacity") = 1U << 16U, py::arg("objectives") = 1)
+        .def("Clear", &pyoperon::FitnessMemo::Clear)
+        .def_property_readonly("Capacity", &pyoperon::FitnessMemo::Capacity)
+        .def_property_readonly("ObjectiveCount", &pyoperon::FitnessMemo::ObjectiveCount);
+
+    m.def("StructuralHash", &pyoperon::StructuralHash, py::arg("tree"));
+    m.def("TreeHash", &pyoperon::TreeHash, py::arg("tree"));
+
+    py::class_<pyoperon::Evaluator, Operon::EvaluatorBase>(m, "Evaluator")
+        .def(py::init<Operon::Problem&, Operon::Interpreter&, Operon::ErrorMetric const&, bool, pyoperon::SolverType>(),
+            py::arg("problem"), py::arg("interpreter"), py::arg("error_metric"), py::arg("linear_scaling") = true, py::arg("solver") = pyoperon::SolverType::Eigen)
+        .def_property("Solver", &pyoperon::Evaluator::Solver, &pyoperon::Evaluator::SetSolver)
+        // local optimization on a per-generation window of rows (0 = whole training range)
+        .def_property("BatchSize", &pyoperon::Evaluator::BatchSize, &pyoperon::Evaluator::SetBatchSize)
+        .def_property("BatchSeed", &pyoperon::Evaluator::BatchSeed, &pyoperon::Evaluator::SetBatchSeed)
+        .def_property_readonly("OptimizationRange", &pyoperon::Evaluator::OptimizationRange)
+        // progressive sampling: fitness rows grow from InitialFraction to the full range over SamplingGenerations (0 = disabled)
+        .def_property("InitialFraction", &pyoperon::Evaluator::InitialFraction, &pyoperon::Evaluator::SetInitialFraction)
+        .def_property("SamplingGenerations", &pyoperon::Evaluator::SamplingGenerations, &pyoperon::Evaluator::SetSamplingGenerations)
+        .def_property_readonly("SampleFraction", &pyoperon::Evaluator::SampleFraction)
+        .def_property_readonly("FitnessRange", &pyoperon::Evaluator::FitnessRange)
+        .def("ResetSchedule", &pyoperon::Evaluator::ResetSchedule)
+        // per-evaluator generation clock, advanced by the algorithm Run methods
+        .def_property_readonly("Generation", &pyoperon::Evaluator::Generation)
+        .def("AdvanceGeneration", &pyoperon::Evaluator::AdvanceGeneration)
+        // early abort of hopeless evaluations (MSE, RMSE, MAE without linear scaling)
+        .def_property("AbortThreshold", &pyoperon::Evaluator::AbortThreshold, &pyoperon::Evaluator::SetAbortThreshold)
+        .def_property("BlockSize", &pyoperon::Evaluator::BlockSize, &pyoperon::Evaluator::SetBlockSize)
+        .def_property_readonly("AbortedEvaluations", &pyoperon::Evaluator::AbortedEvaluations)
+        .def_property_readonly("SupportsAbort", &pyoperon::Evaluator::SupportsAbort)
+        // optimization result cache, kept alive by the evaluator
+        .def_property("Cache", &pyoperon::Evaluator::Cache, py::cpp_function(&pyoperon::Evaluator::SetCache, py::keep_alive<1, 2>()), py::return_value_policy::reference)
+        // fitness memo for duplicate individuals, kept alive by the evaluator
+        .def_property("Memo", &pyoperon::Evaluator::Memo, py::cpp_function(&pyoperon::Evaluator::SetMemo, py::keep_alive<1, 2>()), py::return_value_policy::reference)
+        .def_property_readonly("CacheHits", &pyoperon::Evaluator::CacheHits)
+        // interval pre-filter over {hash: (lo, hi)} input bounds, an empty dict disables it
+        .def_property("Bounds", [](pyoperon::Evaluator const& self) { return detail::FromIntervals(self.Bounds()); },
+            [](pyoperon::Evaluator& self, detail::IntervalMap const& bounds) { self.SetBounds(detail::ToIntervals(bounds)); })
+        .def_property_readonly("RejectedEvaluations", &pyoperon::Evaluator::RejectedEvaluations)
+        // simplify genotypes before evaluating them
+        .def_property("Simplify", &pyoperon::Evaluator::Simplification, &pyoperon::Evaluator::SetSimplification);
 
     py::class_<Operon::UserDefinedEvaluator, Operon::EvaluatorBase>(m, "UserDefinedEvaluator")
         .def(py::init<Operon::Problem&, std::function<typename Operon::EvaluatorBase::ReturnType(Operon::RandomGenerator*, Operon::Individual&)> const&>());
 
+    py::class_<pyoperon::MultiTargetEvaluator, Operon::EvaluatorBase>(m, "MultiTargetEvaluator")
+        .def(py::init<Operon::Problem&, Operon::Interpreter&, Operon::ErrorMetric const&, std::vector<std::string>, bool>(),
+            py::arg("problem"), py::arg("interpreter"), py::arg("error_metric"), py::arg("targets"), py::arg("linear_scaling") = true)
+        .def_property_readonly("Targets", &pyoperon::MultiTargetEvaluator::Targets)
+        .def_property_readonly("ObjectiveCount", &pyoperon::MultiTargetEvaluator::ObjectiveCount);
+
+    // calls python once per batch with a (batch x rows) prediction matrix, timeout in milliseconds.
+    // batches never exceed the worker count: batch_size=0 uses the number of hardware threads
+    py::class_<pyoperon::BatchUserDefinedEvaluator, Operon::EvaluatorBase>(m, "BatchUserDefinedEvaluator")
+        .def(py::init<Operon::Problem&, Operon::Interpreter&, py::function, size_t, double, size_t>(),
+            py::arg("problem"), py::arg("interpreter"), py::arg("function"), py::arg("batch_size") = 0, py::arg("timeout") = 1.0, py::arg("objectives") = 1)
+        .def_property("BatchSize", &pyoperon::BatchUserDefinedEvaluator::BatchSize, &pyoperon::BatchUserDefinedEvaluator::SetBatchSize)
+        .def_property("Timeout", &pyoperon::BatchUserDefinedEvaluator::Timeout, &pyoperon::BatchUserDefinedEvaluator::SetTimeout)
+        .def_property_readonly("ObjectiveCount", &pyoperon::BatchUserDefinedEvaluator::ObjectiveCount)
+        .def_property_readonly("BatchCount", &pyoperon::BatchUserDefinedEvaluator::BatchCount);
+
     py::class_<Operon::LengthEvaluator, Operon::EvaluatorBase>(m, "LengthEvaluator")
         .def(py::init<Operon::Problem&>());
 
@@ -136,7 +451,10 @@ void InitEval(py::module_ &m)
     py::class_<Operon::DiversityEvaluator, Operon::EvaluatorBase>(m, "DiversityEvaluator")
         .def(py::init<Operon::Problem&>());
 
-    py::class_<Operon::MultiEvaluator, Operon::EvaluatorBase>(m, "MultiEvaluator")
+    py::class_<pyoperon::MultiEvaluator, Operon::EvaluatorBase>(m, "MultiEvaluator")
         .def(py::init<Operon::Problem&>())
-        .def("Add", &Operon::MultiEvaluator::Add);
+        .def("Add", &pyoperon::MultiEvaluator::Add, py::keep_alive<1, 2>())
+        .def_property_readonly("ObjectiveCount", &pyoperon::MultiEvaluator::ObjectiveCount)
+        .def_property_readonly("SharedEvaluations", &pyoperon::MultiEvaluator::SharedEvaluations)
+        .def("AdvanceGeneration", &pyoperon::MultiEvaluator::AdvanceGeneration);
 }
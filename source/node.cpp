@@ -4,6 +4,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/operators.h>
 
+#include "pyoperon/primitives.hpp"
 #include "pyoperon/pyoperon.hpp"
 
 #include <operon/core/node.hpp>
@@ -96,6 +97,7 @@ void InitNode(py::module_ &m)
         .def("Cbrt", []() { return Operon::Node(Operon::NodeType::Cbrt); })
         .def("Square", []() { return Operon::Node(Operon::NodeType::Square); })
         .def("Dyn", []() { return Operon::Node(Operon::NodeType::Dynamic); })
+        .def("Dyn", [](std::string const& name) { return pyoperon::PrimitiveRegistry::Instance().MakeNode(name); })
         .def("Constant", [](double v) {
                 Operon::Node constant(Operon::NodeType::Constant);
                 constant.Value = static_cast<Operon::Scalar>(v);
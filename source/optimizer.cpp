@@ -1,8 +1,14 @@
 // SPDX-License-Identifier: MIT
 // SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
 
+#include <algorithm>
+#include <limits>
+
 #include <operon/optimizer/optimizer.hpp>
+#include "pyoperon/evaluator.hpp"
+#include "pyoperon/parallel.hpp"
 #include "pyoperon/pyoperon.hpp"
+#include "pyoperon/refit.hpp"
 
 namespace py = pybind11;
 
@@ -24,10 +30,70 @@ void InitOptimizer(py::module_ &m)
         .def(py::init<Operon::Interpreter const&, Operon::Tree const&, Operon::Dataset const&>())
         .def("Optimize", &EigenOptimizer::Optimize); 
 
-    m.def("Optimize", [](Operon::Interpreter const& interpreter, Operon::Tree const& tree, Operon::Dataset const& ds, py::array_t<Operon::Scalar const> target, Operon::Range range, size_t iterations) {
-        EigenOptimizer optimizer(interpreter, tree, ds);
+    py::class_<TinyOptimizer>(m, "TinyOptimizer")
+        .def(py::init<Operon::Interpreter const&, Operon::Tree const&, Operon::Dataset const&>())
+        .def("Optimize", &TinyOptimizer::Optimize);
+
+#if defined(HAVE_CERES)
+    py::class_<CeresOptimizer>(m, "CeresOptimizer")
+        .def(py::init<Operon::Interpreter const&, Operon::Tree const&, Operon::Dataset const&>())
+        .def("Optimize", &CeresOptimizer::Optimize);
+#endif
+
+    m.def("Optimize", [](Operon::Interpreter const& interpreter, Operon::Tree const& tree, Operon::Dataset const& ds, py::array_t<Operon::Scalar const> target, Operon::Range range, size_t iterations, pyoperon::SolverType solver) {
         Operon::OptimizerSummary summary{};
-        auto coeff = optimizer.Optimize(MakeSpan(target), range, iterations, summary);
+        auto coeff = pyoperon::Optimize(solver, interpreter, tree, ds, MakeSpan(target), range, iterations, summary);
         return std::make_tuple(coeff, summary);
-    });
+    }, py::arg("interpreter"), py::arg("tree"), py::arg("dataset"), py::arg("target"), py::arg("range"), py::arg("iterations"), py::arg("solver") = pyoperon::SolverType::Eigen);
+
+    // optimize the coefficients of many trees in parallel. each task owns its optimizer
+    // (and therefore its jacobian workspace), so no state is shared between workers.
+    // returns an (n x k) matrix where k is the largest coefficient count, rows of trees
+    // with fewer coefficients are padded with NaN, and one summary per tree
+    m.def("OptimizeMany", [](std::vector<Operon::Tree> const& trees, Operon::Dataset const& ds, py::array_t<Operon::Scalar const> target, Operon::Range range, size_t iterations, size_t nthread, pyoperon::SolverType solver) {
+        auto targetSpan = MakeSpan(target);
+        std::vector<std::vector<Operon::Scalar>> coefficients(trees.size());
+        std::vector<Operon::OptimizerSummary> summaries(trees.size());
+        {
+            py::gil_scoped_release release;
+            Operon::Interpreter interpreter;
+            pyoperon::ParallelFor(trees.size(), nthread, [&](size_t i) {
+                coefficients[i] = pyoperon::Optimize(solver, interpreter, trees[i], ds, targetSpan, range, iterations, summaries[i]);
+            });
+        }
+        size_t cols{0};
+        for (auto const& c : coefficients) { cols = std::max(cols, c.size()); }
+        py::array_t<Operon::Scalar> result({ trees.size(), cols });
+        auto* data = result.mutable_data();
+        std::fill_n(data, trees.size() * cols, std::numeric_limits<Operon::Scalar>::quiet_NaN());
+        for (size_t i = 0; i < trees.size(); ++i) {
+            std::copy(coefficients[i].begin(), coefficients[i].end(), data + i * cols);
+        }
+        return std::make_tuple(result, summaries);
+    }, py::arg("trees"), py::arg("dataset"), py::arg("target"), py::arg("range"), py::arg("iterations"), py::arg("nthread") = 0, py::arg("solver") = pyoperon::SolverType::Eigen);
+
+    py::class_<pyoperon::RefitResult>(m, "RefitResult")
+        .def_readonly("Coefficients", &pyoperon::RefitResult::Coefficients)
+        .def_readonly("Scale", &pyoperon::RefitResult::Scale)
+        .def_readonly("Offset", &pyoperon::RefitResult::Offset)
+        .def_readonly("InitialCost", &pyoperon::RefitResult::InitialCost)
+        .def_readonly("FinalCost", &pyoperon::RefitResult::FinalCost)
+        .def_readonly("Iterations", &pyoperon::RefitResult::Iterations);
+
+    // float64 refit of models found by the float32 search (e.g. the final front)
+    m.def("Refit", [](Operon::Tree const& tree, pyoperon::DoubleDataset const& ds, py::array_t<double const, py::array::c_style | py::array::forcecast> target, Operon::Range range, size_t iterations) {
+        auto targetSpan = MakeSpan(target);
+        py::gil_scoped_release release;
+        return pyoperon::Refit(tree, ds, targetSpan, range, iterations);
+    }, py::arg("tree"), py::arg("dataset"), py::arg("target"), py::arg("range"), py::arg("iterations") = 50);
+
+    m.def("RefitMany", [](std::vector<Operon::Tree> const& trees, pyoperon::DoubleDataset const& ds, py::array_t<double const, py::array::c_style | py::array::forcecast> target, Operon::Range range, size_t iterations, size_t nthread) {
+        auto targetSpan = MakeSpan(target);
+        std::vector<pyoperon::RefitResult> results(trees.size());
+        py::gil_scoped_release release;
+        pyoperon::ParallelFor(trees.size(), nthread, [&](size_t i) {
+            results[i] = pyoperon::Refit(trees[i], ds, targetSpan, range, iterations);
+        });
+        return results;
+    }, py::arg("trees"), py::arg("dataset"), py::arg("target"), py::arg("range"), py::arg("iterations") = 50, py::arg("nthread") = 0);
 }
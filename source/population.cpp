@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MIT
+// SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+#include "pyoperon/pyoperon.hpp"
+#include "pyoperon/population.hpp"
+
+namespace py = pybind11;
+
+void InitPopulation(py::module_ &m)
+{
+    using Population = pyoperon::Population;
+
+    py::class_<Population>(m, "Population")
+        .def(py::init<>())
+        .def(py::init([](std::vector<Operon::Individual> const& individuals) {
+            return Population(Operon::Span<Operon::Individual const>(individuals.data(), individuals.size()));
+        }), py::arg("individuals"))
+        .def("__len__", &Population::Size)
+        .def("__getitem__", [](Population const& self, size_t i) {
+            if (i >= self.Size()) { throw py::index_error(); }
+            return self[i];
+        })
+        .def("Assign", [](Population& self, std::vector<Operon::Individual> const& individuals) {
+            self.Assign(Operon::Span<Operon::Individual const>(individuals.data(), individuals.size()));
+        }, py::arg("individuals"))
+        .def("Genotype", &Population::Genotype, py::arg("index"))
+        .def("NondominatedSort", &Population::NondominatedSort, py::arg("eps") = 0, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("Size", &Population::Size)
+        .def_property_readonly("ObjectiveCount", &Population::ObjectiveCount)
+        // (n x m) row-major matrix shared with numpy, no copy is made
+        .def_property_readonly("Fitness", py::overload_cast<>(&Population::Fitness))
+        // read-only structured view of the pooled node storage, trees are delimited by Offsets
+        .def_property_readonly("NodeArray", [](py::object self) {
+            auto array = MakeNodeView(self.cast<Population const&>().Nodes(), self);
+            array.attr("flags").attr("writeable") = false;
+            return array;
+        })
+        // the views below keep the population alive
+        .def_property_readonly("Offsets", [](py::object self) { return MakeView(self.cast<Population const&>().Offsets(), self); })
+        .def_property_readonly("Rank", [](py::object self) { return MakeView(self.cast<Population const&>().Rank(), self); })
+        .def_property_readonly("Distance", [](py::object self) { return MakeView(self.cast<Population const&>().Distance(), self); })
+        .def_property_readonly("Individuals", &Population::Individuals);
+}
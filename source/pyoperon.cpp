@@ -2,6 +2,9 @@
 // SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
 
 #include "pyoperon/pyoperon.hpp"
+#include "pyoperon/cpu.hpp"
+#include "pyoperon/parallel.hpp"
+#include "pyoperon/population.hpp"
 
 #include <operon/algorithms/config.hpp>
 #include <operon/core/version.hpp>
@@ -10,16 +13,58 @@
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(pyoperon, m)
+namespace detail {
+    template<typename Formatter>
+    auto FormatMany(std::vector<Operon::Tree> const& trees, Operon::Map<Operon::Hash, std::string> const& variables, int decimalPrecision, size_t nthread) -> std::vector<std::string>
+    {
+        std::vector<std::string> result(trees.size());
+        pyoperon::ParallelFor(trees.size(), nthread, [&](size_t i) { result[i] = Formatter::Format(trees[i], variables, decimalPrecision); });
+        return result;
+    }
+
+    template<typename Formatter>
+    auto FormatMany(std::vector<Operon::Tree> const& trees, Operon::Dataset const& dataset, int decimalPrecision, size_t nthread) -> std::vector<std::string>
+    {
+        std::vector<std::string> result(trees.size());
+        pyoperon::ParallelFor(trees.size(), nthread, [&](size_t i) { result[i] = Formatter::Format(trees[i], dataset, decimalPrecision); });
+        return result;
+    }
+
+    // binds the batch variants; the variable map is converted once per call and the GIL is released while formatting
+    template<typename Formatter, typename Class>
+    void BindFormatMany(Class& cls)
+    {
+        cls.def_static("FormatMany", [](std::vector<Operon::Tree> const& trees, Operon::Dataset const& dataset, int decimalPrecision, size_t nthread) {
+                py::gil_scoped_release release;
+                return FormatMany<Formatter>(trees, dataset, decimalPrecision, nthread);
+            }, py::arg("trees"), py::arg("dataset"), py::arg("precision"), py::arg("nthread") = 0)
+           .def_static("FormatMany", [](std::vector<Operon::Tree> const& trees, std::unordered_map<Operon::Hash, std::string> const& variables, int decimalPrecision, size_t nthread) {
+                Operon::Map<Operon::Hash, std::string> map(variables.begin(), variables.end());
+                py::gil_scoped_release release;
+                return FormatMany<Formatter>(trees, map, decimalPrecision, nthread);
+            }, py::arg("trees"), py::arg("variables"), py::arg("precision"), py::arg("nthread") = 0);
+    }
+} // namespace detail
+
+// ISA variants of the module are built under a different name
+#ifndef PYOPERON_MODULE_NAME
+#define PYOPERON_MODULE_NAME pyoperon
+#endif
+
+PYBIND11_MODULE(PYOPERON_MODULE_NAME, m)
 {
     m.doc() = "Operon Python Module";
     m.attr("__version__") = 0.1;
 
     // binding code
     py::bind_vector<std::vector<Operon::Variable>>(m, "VariableCollection");
-    py::bind_vector<std::vector<Operon::Individual>>(m, "IndividualCollection");
+    py::bind_vector<std::vector<Operon::Individual>>(m, "IndividualCollection")
+        .def("ToPopulation", [](std::vector<Operon::Individual> const& self) {
+            return pyoperon::Population(Operon::Span<Operon::Individual const>(self.data(), self.size()));
+        });
 
     InitAlgorithm(m);
+    InitArchive(m);
     InitBenchmark(m);
     InitCreator(m);
     InitCrossover(m);
@@ -31,6 +76,7 @@ PYBIND11_MODULE(pyoperon, m)
     InitNode(m);
     InitNondominatedSorter(m);
     InitOptimizer(m);
+    InitPopulation(m);
     InitProblem(m);
     InitPset(m);
     InitReinserter(m);
@@ -39,6 +85,12 @@ PYBIND11_MODULE(pyoperon, m)
 
     // build information
     m.def("Version", &Operon::Version);
+    m.def("CpuFeatures", []() {
+        py::dict features;
+        for (auto const& [name, supported] : pyoperon::CpuFeatures()) { features[name.c_str()] = supported; }
+        features["isa"] = PYOPERON_ISA_LEVEL;
+        return features;
+    });
 
     // random numbers
     m.def("UniformInt", &Operon::Random::Uniform<Operon::RandomGenerator, int>);
@@ -88,7 +140,8 @@ PYBIND11_MODULE(pyoperon, m)
         .def("__call__", &Operon::Random::Sfc64::operator());
 
     // tree format
-    py::class_<Operon::TreeFormatter>(m, "TreeFormatter")
+    py::class_<Operon::TreeFormatter> treeFormatter(m, "TreeFormatter");
+    treeFormatter
         .def("Format", [](Operon::Tree const& tree, Operon::Dataset const& dataset, int decimalPrecision) {
             return Operon::TreeFormatter::Format(tree, dataset, decimalPrecision);
         })
@@ -96,8 +149,10 @@ PYBIND11_MODULE(pyoperon, m)
             Operon::Map<Operon::Hash, std::string> map(variables.begin(), variables.end());
             return Operon::TreeFormatter::Format(tree, map, decimalPrecision);
         });
+    detail::BindFormatMany<Operon::TreeFormatter>(treeFormatter);
 
-    py::class_<Operon::InfixFormatter>(m, "InfixFormatter")
+    py::class_<Operon::InfixFormatter> infixFormatter(m, "InfixFormatter");
+    infixFormatter
         .def("Format", [](Operon::Tree const& tree, Operon::Dataset const& dataset, int decimalPrecision) {
             return Operon::InfixFormatter::Format(tree, dataset, decimalPrecision);
         })
@@ -105,12 +160,21 @@ PYBIND11_MODULE(pyoperon, m)
             Operon::Map<Operon::Hash, std::string> map(variables.begin(), variables.end());
             return Operon::InfixFormatter::Format(tree, map, decimalPrecision);
         });
+    detail::BindFormatMany<Operon::InfixFormatter>(infixFormatter);
 
     py::class_<Operon::InfixParser>(m, "InfixParser")
         .def_static("Parse", [](std::string const& expr, std::unordered_map<std::string, Operon::Hash> const& variables) {
             Operon::Map<std::string, Operon::Hash> map(variables.begin(), variables.end());
             return Operon::InfixParser::Parse(expr, map);
-        });
+        })
+        // accepts any sequence of strings (lists, numpy string arrays)
+        .def_static("ParseMany", [](std::vector<std::string> const& exprs, std::unordered_map<std::string, Operon::Hash> const& variables, size_t nthread) {
+            Operon::Map<std::string, Operon::Hash> map(variables.begin(), variables.end());
+            py::gil_scoped_release release;
+            std::vector<Operon::Tree> trees(exprs.size());
+            pyoperon::ParallelFor(exprs.size(), nthread, [&](size_t i) { trees[i] = Operon::InfixParser::Parse(exprs[i], map); });
+            return trees;
+        }, py::arg("expressions"), py::arg("variables"), py::arg("nthread") = 0);
 
     // genetic algorithm
     py::class_<Operon::GeneticAlgorithmConfig>(m, "GeneticAlgorithmConfig")
@@ -1,13 +1,154 @@
 // SPDX-License-Identifier: MIT
 // SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
 
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <sstream>
+
+#include "pyoperon/parallel.hpp"
 #include "pyoperon/pyoperon.hpp"
+#include "pyoperon/serialize.hpp"
+#include "pyoperon/simplify.hpp"
 #include <operon/core/tree.hpp>
 
+namespace detail {
+    struct NodeField {
+        char const* Name;
+        std::string Format;
+        size_t Offset;
+        size_t Size;
+    };
+
+    // layout description of Operon::Node, shared by the buffer protocol and numpy
+    inline auto NodeFields() -> std::vector<NodeField>
+    {
+        using Operon::Node;
+#define PYOPERON_NODE_FIELD(name, type) \
+        NodeField { #name, py::format_descriptor<type>::format(), offsetof(Node, name), sizeof(type) } // NOLINT
+        static_assert(sizeof(Node::Type) == sizeof(std::underlying_type_t<Operon::NodeType>));
+        return {
+            PYOPERON_NODE_FIELD(HashValue, decltype(Node::HashValue)),
+            PYOPERON_NODE_FIELD(CalculatedHashValue, decltype(Node::CalculatedHashValue)),
+            PYOPERON_NODE_FIELD(Value, decltype(Node::Value)),
+            PYOPERON_NODE_FIELD(Arity, decltype(Node::Arity)),
+            PYOPERON_NODE_FIELD(Length, decltype(Node::Length)),
+            PYOPERON_NODE_FIELD(Depth, decltype(Node::Depth)),
+            PYOPERON_NODE_FIELD(Level, decltype(Node::Level)),
+            PYOPERON_NODE_FIELD(Parent, decltype(Node::Parent)),
+            PYOPERON_NODE_FIELD(Type, std::underlying_type_t<Operon::NodeType>),
+            PYOPERON_NODE_FIELD(IsEnabled, decltype(Node::IsEnabled)),
+            PYOPERON_NODE_FIELD(Optimize, decltype(Node::Optimize)),
+        };
+#undef PYOPERON_NODE_FIELD
+    }
+
+    // PEP 3118 struct format with explicit padding (same scheme as PYBIND11_NUMPY_DTYPE)
+    inline auto NodeFormat() -> std::string
+    {
+        auto fields = NodeFields();
+        std::sort(fields.begin(), fields.end(), [](auto const& a, auto const& b) { return a.Offset < b.Offset; });
+        std::ostringstream oss;
+        oss << "^T{";
+        size_t offset{0};
+        for (auto const& f : fields) {
+            if (f.Offset > offset) { oss << (f.Offset - offset) << 'x'; }
+            oss << f.Format << ':' << f.Name << ':';
+            offset = f.Offset + f.Size;
+        }
+        if (sizeof(Operon::Node) > offset) { oss << (sizeof(Operon::Node) - offset) << 'x'; }
+        oss << '}';
+        return oss.str();
+    }
+
+    template<typename T>
+    auto FieldArray(py::array const& array, char const* name) -> py::array_t<T, py::array::forcecast>
+    {
+        return py::array_t<T, py::array::forcecast>::ensure(array[py::str(name)]);
+    }
+} // namespace detail
+
+auto NodeDtype() -> py::dtype
+{
+    // constructed once and intentionally leaked, like the dtypes registered by pybind11
+    static auto const* dtype = []() {
+        py::list names;
+        py::list formats;
+        py::list offsets;
+        for (auto const& f : detail::NodeFields()) {
+            names.append(f.Name);
+            formats.append(f.Format);
+            offsets.append(f.Offset);
+        }
+        return new py::dtype(names, formats, offsets, sizeof(Operon::Node)); // NOLINT
+    }();
+    return *dtype;
+}
+
+auto MakeNodeView(Operon::Span<Operon::Node const> nodes, py::handle base) -> py::array
+{
+    return py::array(NodeDtype(),
+        { static_cast<py::ssize_t>(nodes.size()) },
+        { static_cast<py::ssize_t>(sizeof(Operon::Node)) },
+        nodes.data(),
+        base);
+}
+
+auto MakeNodes(py::array const& array) -> Operon::Vector<Operon::Node>
+{
+    if (array.ndim() != 1 || array.dtype().attr("names").is_none()) {
+        throw std::runtime_error("Expected a one-dimensional structured array of nodes.");
+    }
+
+    py::tuple names = array.dtype().attr("names");
+    auto has = [&](char const* name) {
+        return std::any_of(names.begin(), names.end(), [&](auto const& n) { return n.template cast<std::string>() == name; });
+    };
+    for (auto const* name : { "Type", "Arity", "HashValue", "Value", "IsEnabled" }) {
+        if (!has(name)) {
+            throw std::runtime_error(std::string("Node array is missing the required field ") + name + ".");
+        }
+    }
+
+    using TypeRep = std::underlying_type_t<Operon::NodeType>;
+    auto type = detail::FieldArray<TypeRep>(array, "Type");
+    auto arity = detail::FieldArray<decltype(Operon::Node::Arity)>(array, "Arity");
+    auto hash = detail::FieldArray<Operon::Hash>(array, "HashValue");
+    auto value = detail::FieldArray<Operon::Scalar>(array, "Value");
+    auto enabled = detail::FieldArray<bool>(array, "IsEnabled");
+    std::optional<py::array_t<Operon::Hash, py::array::forcecast>> calculated;
+    if (has("CalculatedHashValue")) {
+        calculated = detail::FieldArray<Operon::Hash>(array, "CalculatedHashValue");
+    }
+    // arrays without the field keep the default of the Node constructor
+    std::optional<py::array_t<bool, py::array::forcecast>> optimize;
+    if (has("Optimize")) {
+        optimize = detail::FieldArray<bool>(array, "Optimize");
+    }
+
+    auto const n = array.shape(0);
+    Operon::Vector<Operon::Node> nodes;
+    nodes.reserve(static_cast<size_t>(n));
+    for (py::ssize_t i = 0; i < n; ++i) {
+        if (!pyoperon::serialize::IsNodeType(type.at(i))) {
+            throw std::runtime_error("Node array contains an unknown node type " + std::to_string(type.at(i)) + ".");
+        }
+        Operon::Node node(static_cast<Operon::NodeType>(type.at(i)), hash.at(i));
+        node.Arity = arity.at(i);
+        node.Value = value.at(i);
+        node.IsEnabled = enabled.at(i);
+        if (calculated) { node.CalculatedHashValue = calculated->at(i); }
+        if (optimize) { node.Optimize = optimize->at(i); }
+        nodes.push_back(node);
+    }
+    pyoperon::serialize::Validate({ nodes.data(), nodes.size() });
+    return nodes;
+}
+
 void InitTree(py::module_ &m)
 {
     // tree
-    py::class_<Operon::Tree>(m, "Tree")
+    py::class_<Operon::Tree>(m, "Tree", py::buffer_protocol())
         .def(py::init<std::initializer_list<Operon::Node>>())
         .def(py::init<Operon::Vector<Operon::Node>>())
         .def(py::init<const Operon::Tree&>())
@@ -15,6 +156,8 @@ void InitTree(py::module_ &m)
         .def("Sort", &Operon::Tree::Sort)
         .def("Hash", &Operon::Tree::Hash)
         .def("Reduce", &Operon::Tree::Reduce)
+        // algebraic simplification, returns a new tree
+        .def("Simplify", &pyoperon::Simplify)
         .def("ChildIndices", &Operon::Tree::ChildIndices)
         .def("SetEnabled", &Operon::Tree::SetEnabled)
         .def("SetCoefficients", [](Operon::Tree& tree, py::array_t<Operon::Scalar const> coefficients){
@@ -32,16 +175,58 @@ void InitTree(py::module_ &m)
         .def_property_readonly("HashValue", &Operon::Tree::HashValue)
         .def("__getitem__", py::overload_cast<size_t>(&Operon::Tree::operator[]))
         .def("__getitem__", py::overload_cast<size_t>(&Operon::Tree::operator[], py::const_))
+        // read-only view of the node vector as an array of packed node structs
+        .def_buffer([](Operon::Tree& tree) -> py::buffer_info {
+            auto& nodes = tree.Nodes();
+            return py::buffer_info(
+                nodes.data(),
+                sizeof(Operon::Node),
+                detail::NodeFormat(),
+                1,
+                { static_cast<py::ssize_t>(nodes.size()) },
+                { static_cast<py::ssize_t>(sizeof(Operon::Node)) },
+                /*readonly=*/true
+            );
+        })
+        // read-only structured numpy view of the node vector (no copy). modified
+        // copies of the array are turned back into trees with FromNodeArray
+        .def_property_readonly("NodeArray", [](py::object self) {
+            auto const& tree = self.cast<Operon::Tree const&>();
+            auto array = MakeNodeView({ tree.Nodes().data(), tree.Nodes().size() }, self);
+            array.attr("flags").attr("writeable") = false;
+            return array;
+        })
+        .def_static("FromNodeArray", [](py::array const& array) {
+            return Operon::Tree(MakeNodes(array)).UpdateNodes();
+        }, py::arg("nodes"))
+        // packed binary serialization (see pyoperon/serialize.hpp for the format)
+        .def("ToBytes", [](Operon::Tree const& tree) {
+            return py::bytes(pyoperon::serialize::ToBytes(tree));
+        })
+        .def_static("FromBytes", [](py::bytes const& bytes) {
+            return pyoperon::serialize::FromBytes(static_cast<std::string_view>(bytes));
+        }, py::arg("bytes"))
         .def(py::pickle(
             [](Operon::Tree const& tree) {
-                return py::make_tuple(tree.Nodes());
+                return py::make_tuple(py::bytes(pyoperon::serialize::ToBytes(tree)));
             },
             [](py::tuple t) {
                 if (t.size() != 1) {
                     throw std::runtime_error("Invalid state!");
                 }
+                if (py::isinstance<py::bytes>(t[0])) {
+                    return pyoperon::serialize::FromBytes(static_cast<std::string_view>(t[0].cast<py::bytes>()));
+                }
+                // legacy state: a list of pickled nodes
                 return Operon::Tree(t[0].cast<Operon::Vector<Operon::Node>>()).UpdateNodes();
             }
         ));
 
+    m.def("SimplifyMany", [](std::vector<Operon::Tree> const& trees, size_t nthread) {
+        std::vector<Operon::Tree> result(trees.size());
+        py::gil_scoped_release release;
+        pyoperon::ParallelFor(trees.size(), nthread, [&](size_t i) { result[i] = pyoperon::Simplify(trees[i]); });
+        py::gil_scoped_acquire acquire;
+        return result;
+    }, py::arg("trees"), py::arg("nthread") = 0);
 }
@@ -0,0 +1,34 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS
+
+
+@pytest.fixture
+def data():
+    # y = 2 * x1 - 3 * x2 + 1 on [-1, 1]^2
+    rng = np.random.default_rng(1234)
+    x = rng.uniform(-1, 1, size=(ROWS, 2))
+    y = 2 * x[:, 0] - 3 * x[:, 1] + 1
+    return np.column_stack([x, y])
+
+
+@pytest.fixture
+def dataset(data):
+    ds = op.Dataset(np.asfortranarray(data, dtype=np.float32))
+    ds.VariableNames = ['x1', 'x2', 'y']
+    return ds
+
+
+@pytest.fixture
+def inputs(dataset):
+    return op.VariableCollection(v for v in dataset.Variables if v.Name != 'y')
+
+
+@pytest.fixture
+def problem(dataset, inputs):
+    return op.Problem(dataset, inputs, 'y', op.Range(0, ROWS), op.Range(0, ROWS))
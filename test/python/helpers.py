@@ -0,0 +1,56 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import pyoperon as op
+
+ROWS = 64
+
+
+def variable(dataset, name, weight=1.0):
+    node = op.Node.Variable(weight)
+    node.HashValue = dataset.GetVariable(name).Hash
+    return node
+
+
+def linear_tree(dataset, w1=2.0, w2=-3.0, c=1.0):
+    """The tree w1 * x1 + w2 * x2 + c, exact for the fixture data with the default weights."""
+    nodes = [variable(dataset, 'x1', w1), variable(dataset, 'x2', w2), op.Node.Add(), op.Node.Constant(c), op.Node.Add()]
+    return op.Tree(nodes).UpdateNodes()
+
+
+def individual(tree, *fitness):
+    ind = op.Individual(max(len(fitness), 1))
+    ind.Genotype = tree
+    for i, f in enumerate(fitness):
+        ind.SetFitness(f, i)
+    return ind
+
+
+class GeneticProgramming:
+    """A small single-objective GP setup. The operators are attributes, since the algorithm only holds references to them."""
+
+    def __init__(self, problem, inputs, evaluator, generations=5, population_size=50, seed=1):
+        self.evaluator = evaluator
+        self.config = op.GeneticAlgorithmConfig(generations=generations, max_evaluations=1000000, local_iterations=0,
+                                                population_size=population_size, pool_size=population_size,
+                                                p_crossover=1.0, p_mutation=0.25, epsilon=1e-5, seed=seed, time_limit=3600)
+        self.selector = op.TournamentSelector(objective_index=0)
+        self.pset = op.PrimitiveSet()
+        self.pset.SetConfig(op.PrimitiveSet.Arithmetic)
+        self.creator = op.BalancedTreeCreator(self.pset, inputs, bias=0.0)
+        self.initializer = op.UniformLengthTreeInitializer(self.creator)
+        self.initializer.ParameterizeDistribution(1, 20)
+        self.initializer.MaxDepth = 10
+        self.coefficients = op.NormalCoefficientInitializer()
+        self.coefficients.ParameterizeDistribution(0, 1)
+        self.mutation = op.NormalOnePointMutation()
+        self.crossover = op.SubtreeCrossover(0.9, 10, 20)
+        self.generator = op.BasicOffspringGenerator(evaluator, self.crossover, self.mutation, self.selector, self.selector)
+        self.reinserter = op.ReplaceWorstReinserter(objective_index=0)
+        self.algorithm = op.GeneticProgrammingAlgorithm(problem, self.config, self.initializer, self.coefficients,
+                                                        self.generator, self.reinserter)
+        self.rng = op.RomuTrio(seed)
+
+    def run(self, callback=lambda: None, threads=1):
+        self.algorithm.Run(self.rng, callback, threads=threads)
+        return self.algorithm
@@ -0,0 +1,36 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import math
+
+import numpy as np
+
+import pyoperon as op
+from helpers import ROWS, GeneticProgramming, linear_tree
+
+
+def test_calculate_fitness_many(dataset):
+    # the batch overload reuses one scratch buffer for all trees
+    interpreter = op.Interpreter()
+    trees = [linear_tree(dataset, w1=w) for w in (2.0, 1.0, 0.0, -1.0)]
+    rows = op.Range(0, ROWS)
+    many = op.CalculateFitness(interpreter, trees, dataset, rows, 'y', 'mse')
+    single = [op.CalculateFitness(interpreter, t, dataset, rows, 'y', 'mse') for t in trees]
+    np.testing.assert_allclose(many, single, rtol=1e-6)
+    assert many[0] < 1e-10
+
+
+def test_run_threads(problem, inputs):
+    # scratch buffers come from per-thread arenas released at every generation
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error, True)
+    gp = GeneticProgramming(problem, inputs, evaluator, generations=5)
+    generations = []
+    algorithm = gp.run(lambda: generations.append(gp.algorithm.Generation), threads=4)
+    assert len(generations) > 0
+    assert math.isfinite(algorithm.BestModel.GetFitness(0))
+
+    # a second run reuses the warm arenas
+    algorithm.Reset()
+    algorithm = gp.run(threads=4)
+    assert math.isfinite(algorithm.BestModel.GetFitness(0))
@@ -0,0 +1,98 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import struct
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, individual, linear_tree
+
+INDEX_HEADER_SIZE = 8
+
+
+@pytest.fixture
+def individuals(dataset):
+    return [individual(linear_tree(dataset, w1=w), w, -w) for w in (0.5, 1.0, 1.5, 2.0)]
+
+
+def values(tree):
+    return [n.Value for n in tree.Nodes]
+
+
+def test_round_trip(tmp_path, individuals):
+    path = str(tmp_path / 'archive.bin')
+    archive = op.PopulationArchive(path, 2)
+    assert len(archive) == 0
+    archive.Append(individuals[0])
+    archive.Append(individuals[1:])
+    assert archive.Size == len(individuals)
+
+    for i, ind in enumerate(individuals):
+        assert values(archive.Tree(i)) == values(ind.Genotype)
+        np.testing.assert_array_equal(archive.Fitness(i), [ind.GetFitness(0), ind.GetFitness(1)])
+    assert [values(ind.Genotype) for ind in archive.Individuals(1, 100)] == [values(ind.Genotype) for ind in individuals[1:]]
+    with pytest.raises(IndexError):
+        archive[len(individuals)]
+
+    # reopening infers the objective count, appends go to the end
+    del archive
+    reopened = op.PopulationArchive(path)
+    assert reopened.ObjectiveCount == 2
+    assert reopened.Size == len(individuals)
+    reopened.Append(individuals[0])
+    assert reopened.Size == len(individuals) + 1
+    assert values(reopened.Tree(len(individuals))) == values(individuals[0].Genotype)
+
+
+def test_objective_count(tmp_path, individuals):
+    path = str(tmp_path / 'archive.bin')
+    with pytest.raises(RuntimeError):
+        op.PopulationArchive(path)
+    archive = op.PopulationArchive(path, 3)
+    with pytest.raises(RuntimeError):
+        archive.Append(individuals[0])
+    with pytest.raises(RuntimeError):
+        op.PopulationArchive(path, 2)
+
+
+def test_corrupt_index(tmp_path, individuals):
+    path = tmp_path / 'archive.bin'
+    op.PopulationArchive(str(path), 2).Append(individuals)
+
+    # point the second record past the end of the data file
+    index = bytearray((tmp_path / 'archive.bin.idx').read_bytes())
+    struct.pack_into('<Q', index, INDEX_HEADER_SIZE + 8, path.stat().st_size + 1)
+    (tmp_path / 'archive.bin.idx').write_bytes(bytes(index))
+
+    archive = op.PopulationArchive(str(path))
+    assert archive.Size == len(individuals)
+    with pytest.raises(RuntimeError):
+        archive.Tree(1)
+    with pytest.raises(RuntimeError):
+        archive.Fitness(1)
+
+
+def test_not_an_archive(tmp_path):
+    path = tmp_path / 'archive.bin'
+    path.write_bytes(b'not an archive at all')
+    (tmp_path / 'archive.bin.idx').write_bytes(b'OPAI\x01\x00\x00\x00')
+    with pytest.raises(RuntimeError):
+        op.PopulationArchive(str(path))
+
+
+def test_evaluate_trees(tmp_path, dataset, individuals):
+    archive = op.PopulationArchive(str(tmp_path / 'archive.bin'), 2)
+    archive.Append(individuals)
+    rows = op.Range(0, ROWS)
+
+    streamed = np.zeros(len(individuals) * ROWS, dtype=np.float32)
+    op.EvaluateTrees(archive, dataset, rows, streamed, nthread=2, batch_size=3)
+
+    expected = np.zeros(len(individuals) * ROWS, dtype=np.float32)
+    op.EvaluateTrees([ind.Genotype for ind in individuals], dataset, rows, expected, nthread=2)
+    np.testing.assert_array_equal(streamed, expected)
+
+    with pytest.raises(RuntimeError):
+        op.EvaluateTrees(archive, dataset, rows, np.zeros(ROWS, dtype=np.float32))
@@ -0,0 +1,83 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import math
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, GeneticProgramming, individual, linear_tree
+
+
+def test_direct_call(problem, dataset, data):
+    interpreter = op.Interpreter()
+    seen = []
+
+    def mse(predictions):
+        seen.append(predictions.copy())
+        return np.mean((predictions - data[:, 2]) ** 2, axis=1)
+
+    evaluator = op.BatchUserDefinedEvaluator(problem, interpreter, mse, batch_size=8)
+    assert evaluator.BatchSize == 8 and evaluator.ObjectiveCount == 1
+
+    # called from python, the request is evaluated on its own right away
+    tree = linear_tree(dataset, 1.0, 1.0, 0.0)
+    fitness = evaluator(op.RomuTrio(1), individual(tree))
+    assert evaluator.BatchCount == 1
+    assert seen[0].shape == (1, ROWS)
+    np.testing.assert_array_equal(seen[0][0], op.Evaluate(interpreter, tree, dataset, op.Range(0, ROWS)))
+    np.testing.assert_allclose(fitness, [mse(seen[0])[0]], rtol=1e-6)
+
+
+def test_objectives(problem, dataset, data):
+    interpreter = op.Interpreter()
+
+    def two(predictions):
+        residual = predictions - data[:, 2]
+        return np.column_stack([np.mean(residual ** 2, axis=1), np.mean(np.abs(residual), axis=1)])
+
+    evaluator = op.BatchUserDefinedEvaluator(problem, interpreter, two, objectives=2)
+    assert evaluator.ObjectiveCount == 2
+    fitness = evaluator(op.RomuTrio(1), individual(linear_tree(dataset, 1.0, 1.0, 0.0)))
+    assert len(fitness) == 2
+
+    with pytest.raises(ValueError):
+        op.BatchUserDefinedEvaluator(problem, interpreter, two, objectives=0)
+
+
+def test_invalid_results(problem, dataset):
+    interpreter = op.Interpreter()
+    rng = op.RomuTrio(1)
+    ind = individual(linear_tree(dataset))
+
+    def raises(predictions):
+        raise KeyError('boom')
+
+    for function, objectives in [(lambda p: np.zeros((len(p), 2)), 1),   # objective count
+                                 (lambda p: np.zeros(len(p)), 2),
+                                 (lambda p: np.zeros(len(p) + 1), 1),     # row count
+                                 (raises, 1)]:
+        evaluator = op.BatchUserDefinedEvaluator(problem, interpreter, function, objectives=objectives)
+        with pytest.raises(RuntimeError):
+            evaluator(rng, ind)
+
+
+def test_batches_in_run(problem, inputs, data):
+    interpreter = op.Interpreter()
+    sizes = []
+
+    def mse(predictions):
+        sizes.append(len(predictions))
+        return np.mean((predictions - data[:, 2]) ** 2, axis=1)
+
+    threads = 4
+    evaluator = op.BatchUserDefinedEvaluator(problem, interpreter, mse, batch_size=threads, timeout=5.0)
+    gp = GeneticProgramming(problem, inputs, evaluator, generations=3)
+    algorithm = gp.run(threads=threads)
+
+    # a batch never holds more individuals than there are workers, and every request is answered once
+    assert evaluator.BatchCount == len(sizes)
+    assert max(sizes) <= threads
+    assert sum(sizes) == evaluator.CallCount
+    assert math.isfinite(algorithm.BestModel.GetFitness(0))
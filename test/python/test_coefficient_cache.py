@@ -0,0 +1,77 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import gc
+
+import numpy as np
+
+import pyoperon as op
+from helpers import individual, linear_tree
+
+
+def test_structural_hash(dataset):
+    a = linear_tree(dataset, 1.0, 1.0, 0.0)
+    b = linear_tree(dataset, 0.5, 2.0, 3.0)
+    assert op.StructuralHash(a) == op.StructuralHash(b)
+    assert op.TreeHash(a) != op.TreeHash(b)
+    assert op.TreeHash(a) == op.TreeHash(op.Tree(a))
+
+
+def make_evaluator(problem, interpreter, error):
+    evaluator = op.Evaluator(problem, interpreter, error, False)
+    evaluator.LocalOptimizationIterations = 50
+    return evaluator
+
+
+def test_hit(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = make_evaluator(problem, interpreter, error)
+    cache = op.CoefficientCache(1000)
+    evaluator.Cache = cache
+    rng = op.RomuTrio(1)
+
+    first = individual(linear_tree(dataset, 1.0, 1.0, 0.0))
+    f1 = evaluator(rng, first)
+    assert (cache.Hits, cache.Misses, len(cache)) == (0, 1, 1)
+    evaluations = evaluator.ResidualEvaluations
+
+    # same structure, other coefficients: the cached solution and fitness are reused without solving
+    second = individual(linear_tree(dataset, -4.0, 0.5, 7.0))
+    f2 = evaluator(rng, second)
+    assert cache.Hits == 1
+    assert evaluator.ResidualEvaluations == evaluations
+    assert f2[0] == f1[0]
+    np.testing.assert_array_equal(second.Genotype.GetCoefficients(), first.Genotype.GetCoefficients())
+
+    cache.Clear()
+    assert (cache.Hits, cache.Misses, cache.Size) == (0, 0, 0)
+
+
+def test_warm_start_on_batches(problem, dataset):
+    # with mini-batches a hit only seeds the solver, the individual is still optimized and evaluated
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = make_evaluator(problem, interpreter, error)
+    evaluator.BatchSize = 16
+    cache = op.CoefficientCache()
+    evaluator.Cache = cache
+    rng = op.RomuTrio(1)
+
+    exact = op.Evaluator(problem, interpreter, error, False)
+    exact.LocalOptimizationIterations = 50
+    exact.Cache = cache
+    exact(rng, individual(linear_tree(dataset, 1.0, 1.0, 0.0)))
+
+    evaluations = evaluator.ResidualEvaluations
+    f = evaluator(rng, individual(linear_tree(dataset, -4.0, 0.5, 7.0)))
+    assert cache.Hits == 1
+    assert evaluator.ResidualEvaluations > evaluations
+    assert f[0] < 1e-6
+
+
+def test_cache_kept_alive(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = make_evaluator(problem, interpreter, error)
+    evaluator.Cache = op.CoefficientCache(100)
+    gc.collect()
+    evaluator(op.RomuTrio(1), individual(linear_tree(dataset, 1.0, 1.0, 0.0)))
+    assert evaluator.Cache.Size == 1
@@ -0,0 +1,55 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import pickle
+import platform
+import sys
+
+import pytest
+
+import pyoperon as op
+
+X86_64 = platform.machine().lower() in ('x86_64', 'amd64')
+
+# each level includes the previous one (see pyoperon/cpu.hpp)
+LEVELS = {
+    'x86-64-v2': ['sse3', 'ssse3', 'sse4_1', 'sse4_2', 'popcnt', 'cx16', 'lahf'],
+    'x86-64-v3': ['avx', 'avx2', 'bmi', 'bmi2', 'f16c', 'fma', 'lzcnt', 'movbe'],
+    'x86-64-v4': ['avx512f', 'avx512bw', 'avx512cd', 'avx512dq', 'avx512vl'],
+}
+
+
+def required(level):
+    names = list(LEVELS)
+    return [f for name in names[:names.index(level) + 1] for f in LEVELS[name]]
+
+
+def supported_levels(features):
+    return [level for level in reversed(LEVELS) if all(features[f] for f in required(level))]
+
+
+def test_features():
+    features = op.CpuFeatures()
+    isa = features.pop('isa')
+    if not X86_64:
+        assert isa == 'generic'
+        return
+    assert set(required('x86-64-v4')) <= set(features)
+    assert all(isinstance(v, bool) for v in features.values())
+    # the loaded module is the baseline or a variant the host supports
+    assert isa == 'x86-64' or isa in supported_levels(features)
+
+
+def test_supported_levels():
+    cpuinfo = pytest.importorskip('pyoperon._cpuinfo')
+    expected = supported_levels(op.CpuFeatures()) if X86_64 else []
+    assert cpuinfo.SupportedIsaLevels() == expected
+
+
+def test_module_alias():
+    # pickles of earlier releases refer to pyoperon.pyoperon, which must be the loaded module
+    assert 'pyoperon.pyoperon' in sys.modules
+    assert sys.modules['pyoperon.pyoperon'].Tree is op.Tree
+    assert op.Tree.__module__ == 'pyoperon'
+    tree = op.Tree([op.Node.Constant(1.0)]).UpdateNodes()
+    assert pickle.loads(pickle.dumps(tree)).Length == 1
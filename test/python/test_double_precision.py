@@ -0,0 +1,61 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, linear_tree
+
+
+@pytest.fixture
+def double_dataset(data):
+    ds = op.DoubleDataset(data)
+    ds.VariableNames = ['x1', 'x2', 'y']
+    return ds
+
+
+def test_dataset(double_dataset, data):
+    ds = double_dataset
+    assert (ds.Rows, ds.Cols) == data.shape
+    np.testing.assert_array_equal(ds.Values, data)
+    for i, name in enumerate(['x1', 'x2', 'y']):
+        assert ds.GetValues(name).dtype == np.float64
+        np.testing.assert_array_equal(ds.GetValues(name), data[:, i])
+        np.testing.assert_array_equal(ds.GetValues(ds.Dataset.GetVariable(name).Hash), data[:, i])
+    # the float32 copy used by the search
+    np.testing.assert_array_equal(ds.Dataset.GetValues('y'), data[:, 2].astype(np.float32))
+    assert ds.Dataset.VariableNames == ['x1', 'x2', 'y']
+
+
+def test_interpreters(double_dataset, data):
+    tree = linear_tree(double_dataset.Dataset)
+    rows = op.Range(0, ROWS)
+
+    result = op.Interpreter64().Evaluate(tree, double_dataset, rows)
+    assert result.dtype == np.float64
+    np.testing.assert_allclose(result, data[:, 2], rtol=0, atol=1e-12)
+
+    result = op.Interpreter32().Evaluate(tree, double_dataset.Dataset, rows)
+    assert result.dtype == np.float32
+    np.testing.assert_allclose(result, data[:, 2], rtol=1e-5, atol=1e-5)
+
+
+def test_coefficients(double_dataset, data):
+    tree = linear_tree(double_dataset.Dataset, 1.0, 1.0, 0.0)
+    interpreter = op.Interpreter64()
+    rows = op.Range(0, ROWS)
+    result = interpreter.Evaluate(tree, double_dataset, rows, coefficients=np.array([2.0, -3.0, 1.0]))
+    np.testing.assert_allclose(result, data[:, 2], rtol=0, atol=1e-12)
+    # the tree keeps its own coefficients
+    assert tree.GetCoefficients() == [1, 1, 0]
+    with pytest.raises(RuntimeError):
+        interpreter.Evaluate(tree, double_dataset, rows, coefficients=np.array([1.0, 2.0]))
+
+
+def test_scaled_evaluate(double_dataset, data):
+    # y = 2 * (x1 - 1.5 * x2) + 1
+    tree = linear_tree(double_dataset.Dataset, 1.0, -1.5, 0.0)
+    prediction, scale, offset = op.Interpreter64().ScaledEvaluate(tree, double_dataset, op.Range(0, ROWS), data[:, 2])
+    np.testing.assert_allclose(prediction, data[:, 0] - 1.5 * data[:, 1], atol=1e-12)
+    np.testing.assert_allclose([scale, offset], [2, 1], atol=1e-9)
@@ -0,0 +1,49 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import math
+
+import numpy as np
+
+import pyoperon as op
+from helpers import individual, linear_tree
+
+
+def test_supports_abort(problem):
+    interpreter = op.Interpreter()
+    for error, scaling, expected in [(op.MSE(), False, True), (op.RMSE(), False, True), (op.MAE(), False, True),
+                                     (op.MSE(), True, False), (op.R2(), False, False)]:
+        assert op.Evaluator(problem, interpreter, error, scaling).SupportsAbort == expected
+
+
+def test_abort(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    plain = op.Evaluator(problem, interpreter, error, False)
+    plain.LocalOptimizationIterations = 0
+
+    evaluator = op.Evaluator(problem, interpreter, error, False)
+    evaluator.LocalOptimizationIterations = 0
+    assert math.isnan(evaluator.AbortThreshold)
+    evaluator.AbortThreshold = 0.5
+    evaluator.BlockSize = 8
+    rng = op.RomuTrio(1)
+
+    # a good model is evaluated completely and gets its exact fitness
+    good = linear_tree(dataset, 2.0, -3.0, 1.5)
+    np.testing.assert_allclose(evaluator(rng, individual(good))[0], plain(rng, individual(good))[0], rtol=1e-5)
+    assert evaluator.AbortedEvaluations == 0
+
+    # a hopeless one stops early with a lower bound of its error that is not below the threshold
+    bad = linear_tree(dataset, 2.0, -3.0, 100.0)
+    partial = evaluator(rng, individual(bad))[0]
+    assert evaluator.AbortedEvaluations == 1
+    assert 0.5 <= partial <= plain(rng, individual(bad))[0]
+
+    # RMSE compares the root of the accumulated error with the threshold
+    rmse = op.RMSE()
+    evaluator = op.Evaluator(problem, interpreter, rmse, False)
+    evaluator.LocalOptimizationIterations = 0
+    evaluator.AbortThreshold = 10.0
+    evaluator.BlockSize = 8
+    assert 10.0 <= evaluator(rng, individual(bad))[0] <= 99.0 + 1e-3
+    assert evaluator.AbortedEvaluations == 1
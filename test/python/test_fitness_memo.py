@@ -0,0 +1,86 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+
+import pyoperon as op
+from helpers import GeneticProgramming, individual, linear_tree
+
+
+def make_evaluator(problem, interpreter, error, memo):
+    evaluator = op.Evaluator(problem, interpreter, error, True)
+    evaluator.LocalOptimizationIterations = 0
+    evaluator.Memo = memo
+    return evaluator
+
+
+def test_hit(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    memo = op.FitnessMemo(1024)
+    assert memo.Capacity == 1024 and memo.ObjectiveCount == 1
+    evaluator = make_evaluator(problem, interpreter, error, memo)
+    rng = op.RomuTrio(1)
+
+    tree = linear_tree(dataset, 1.0, 1.0, 0.0)
+    f1 = evaluator(rng, individual(tree))
+    evaluations = evaluator.ResidualEvaluations
+    assert evaluator.CacheHits == 0
+
+    # a clone is not evaluated again
+    f2 = evaluator(rng, individual(op.Tree(tree)))
+    assert evaluator.CacheHits == 1
+    assert evaluator.ResidualEvaluations == evaluations
+    assert f2[0] == f1[0]
+
+    # other coefficients are another key
+    evaluator(rng, individual(linear_tree(dataset, 1.0, 1.0, 0.5)))
+    assert evaluator.CacheHits == 1
+    assert evaluator.ResidualEvaluations == evaluations + 1
+
+    memo.Clear()
+    evaluator(rng, individual(op.Tree(tree)))
+    assert evaluator.CacheHits == 1
+
+
+def test_shared_between_metrics(problem, dataset):
+    # keys are salted with the error metric, a shared memo never mixes objectives
+    interpreter, mse, mae = op.Interpreter(), op.MSE(), op.MAE()
+    memo = op.FitnessMemo()
+    a = make_evaluator(problem, interpreter, mse, memo)
+    b = make_evaluator(problem, interpreter, mae, memo)
+    rng = op.RomuTrio(1)
+
+    tree = linear_tree(dataset, 1.0, 1.0, 0.0)
+    fa = a(rng, individual(tree))
+    fb = b(rng, individual(op.Tree(tree)))
+    assert b.CacheHits == 0
+    assert fa[0] != fb[0]
+    assert b(rng, individual(op.Tree(tree)))[0] == fb[0]
+    assert b.CacheHits == 1
+
+
+def test_not_used_with_local_optimization(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = make_evaluator(problem, interpreter, error, op.FitnessMemo())
+    evaluator.LocalOptimizationIterations = 10
+    rng = op.RomuTrio(1)
+    tree = linear_tree(dataset, 1.0, 1.0, 0.0)
+    evaluator(rng, individual(tree))
+    evaluator(rng, individual(op.Tree(tree)))
+    assert evaluator.CacheHits == 0
+
+
+def test_concurrent_run(problem, inputs):
+    # every parent of a multi-threaded run with a shared memo carries its own fitness
+    interpreter, error = op.Interpreter(), op.MSE()
+    memo = op.FitnessMemo(1 << 12)
+    evaluator = make_evaluator(problem, interpreter, error, memo)
+    gp = GeneticProgramming(problem, inputs, evaluator, generations=5, population_size=100)
+    algorithm = gp.run(threads=4)
+
+    reference = op.Evaluator(problem, interpreter, error, True)
+    reference.LocalOptimizationIterations = 0
+    rng = op.RomuTrio(1)
+    for ind in algorithm.Individuals[:20]:
+        expected = reference(rng, individual(op.Tree(ind.Genotype)))[0]
+        np.testing.assert_allclose(ind.GetFitness(0), expected, rtol=1e-5, atol=1e-7)
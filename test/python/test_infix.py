@@ -0,0 +1,49 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+
+import pyoperon as op
+from helpers import ROWS
+
+EXPRESSIONS = {
+    'x1 * 2 + 3': lambda x1, x2: x1 * 2 + 3,
+    'sin(x1) + x2': lambda x1, x2: np.sin(x1) + x2,
+    'x1 / (x2 + 5)': lambda x1, x2: x1 / (x2 + 5),
+    'exp(x1 - x2) * x1': lambda x1, x2: np.exp(x1 - x2) * x1,
+}
+
+
+def variables(dataset):
+    return {v.Name: v.Hash for v in dataset.Variables}
+
+
+def test_parse_many(dataset, data):
+    exprs = list(EXPRESSIONS)
+    trees = op.InfixParser.ParseMany(exprs, variables(dataset), nthread=4)
+    assert len(trees) == len(exprs)
+
+    interpreter = op.Interpreter()
+    rows = op.Range(0, ROWS)
+    for expr, tree in zip(exprs, trees):
+        single = op.InfixParser.Parse(expr, variables(dataset))
+        np.testing.assert_array_equal(op.Evaluate(interpreter, tree, dataset, rows),
+                                      op.Evaluate(interpreter, single, dataset, rows))
+        np.testing.assert_allclose(op.Evaluate(interpreter, tree, dataset, rows),
+                                   EXPRESSIONS[expr](data[:, 0], data[:, 1]), rtol=1e-5, atol=1e-6)
+
+
+def test_parse_many_numpy_strings(dataset):
+    exprs = np.array(list(EXPRESSIONS))
+    trees = op.InfixParser.ParseMany(exprs, variables(dataset))
+    assert [t.Length for t in trees] == [op.InfixParser.Parse(e, variables(dataset)).Length for e in EXPRESSIONS]
+
+
+def test_format_many(dataset):
+    trees = op.InfixParser.ParseMany(list(EXPRESSIONS), variables(dataset))
+    names = {v.Hash: v.Name for v in dataset.Variables}
+    for formatter in (op.InfixFormatter, op.TreeFormatter):
+        expected = [formatter.Format(t, dataset, 6) for t in trees]
+        assert formatter.FormatMany(trees, dataset, 6, nthread=4) == expected
+        assert formatter.FormatMany(trees, names, 6, nthread=1) == expected
+    assert op.InfixFormatter.FormatMany([], dataset, 6) == []
@@ -0,0 +1,96 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import math
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, individual, linear_tree, variable
+
+FLOAT_MAX = np.finfo(np.float32).max
+
+
+def unit_bounds(dataset, names=('x1', 'x2')):
+    return {dataset.GetVariable(n).Hash: (-1.0, 1.0) for n in names}
+
+
+def ratio_tree(dataset):
+    # x2 / x1
+    return op.Tree([variable(dataset, 'x1'), variable(dataset, 'x2'), op.Node.Div()]).UpdateNodes()
+
+
+def test_linear(dataset):
+    # 2 * x1 - 3 * x2 + 1 over [-1, 1]^2
+    assert op.EvaluateInterval(linear_tree(dataset), unit_bounds(dataset)) == pytest.approx((-4, 6))
+    bounds = unit_bounds(dataset)
+    bounds[dataset.GetVariable('x2').Hash] = (0.0, 0.5)
+    assert op.EvaluateInterval(linear_tree(dataset), bounds) == pytest.approx((-2.5, 3))
+
+
+def test_unbounded_and_undefined(dataset):
+    lo, hi = op.EvaluateInterval(ratio_tree(dataset), unit_bounds(dataset))
+    assert (lo, hi) == (-math.inf, math.inf)
+
+    log = op.Tree([variable(dataset, 'x1'), op.Node.Log()]).UpdateNodes()
+    lo, hi = op.EvaluateInterval(log, unit_bounds(dataset))
+    assert math.isnan(lo) and math.isnan(hi)
+    bounds = {dataset.GetVariable('x1').Hash: (1.0, math.e)}
+    assert op.EvaluateInterval(log, bounds) == pytest.approx((0, 1))
+
+
+def test_errors(dataset):
+    with pytest.raises(RuntimeError):
+        op.EvaluateInterval(linear_tree(dataset), unit_bounds(dataset, ['x1']))
+    bounds = unit_bounds(dataset)
+    bounds[dataset.GetVariable('x1').Hash] = (1.0, -1.0)
+    with pytest.raises(ValueError):
+        op.EvaluateInterval(linear_tree(dataset), bounds)
+
+
+def test_many(dataset):
+    trees = [linear_tree(dataset), linear_tree(dataset, 0.5, 0.5, 0.0), ratio_tree(dataset)]
+    bounds = unit_bounds(dataset)
+    result = op.EvaluateIntervals(trees, bounds, nthread=2)
+    assert result.shape == (len(trees), 2)
+    for tree, row in zip(trees, result):
+        assert tuple(row) == op.EvaluateInterval(tree, bounds)
+
+
+def test_variable_bounds(dataset, data):
+    bounds = op.VariableBounds(dataset, op.Range(0, ROWS))
+    for i, name in enumerate(['x1', 'x2', 'y']):
+        values = data[:, i].astype(np.float32)
+        assert bounds[dataset.GetVariable(name).Hash] == pytest.approx((values.min(), values.max()))
+
+    # the output interval contains every evaluated value
+    tree = linear_tree(dataset, 0.5, 1.0, 0.0)
+    lo, hi = op.EvaluateInterval(tree, bounds)
+    values = op.Evaluate(op.Interpreter(), tree, dataset, op.Range(0, ROWS))
+    assert lo <= values.min() and values.max() <= hi
+
+
+def test_evaluator(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error, True)
+    evaluator.LocalOptimizationIterations = 0
+
+    # the target does not need an interval, every input does
+    evaluator.Bounds = unit_bounds(dataset)
+    assert evaluator.Bounds == unit_bounds(dataset)
+    with pytest.raises(ValueError):
+        evaluator.Bounds = unit_bounds(dataset, ['x1'])
+
+    rng = op.RomuTrio(1)
+    assert evaluator(rng, individual(linear_tree(dataset)))[0] < 1e-6
+    assert evaluator.RejectedEvaluations == 0
+
+    # the data never hits x1 = 0, but the domain does
+    assert evaluator(rng, individual(ratio_tree(dataset)))[0] == FLOAT_MAX
+    assert evaluator.RejectedEvaluations == 1
+
+    # without bounds the individual is scored
+    evaluator.Bounds = {}
+    assert evaluator(rng, individual(ratio_tree(dataset)))[0] < FLOAT_MAX
+    assert evaluator.RejectedEvaluations == 1
@@ -0,0 +1,82 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, linear_tree, variable
+
+
+@pytest.fixture
+def double_dataset(data):
+    ds = op.DoubleDataset(data)
+    ds.VariableNames = ['x1', 'x2', 'y']
+    return ds
+
+
+def nonlinear_tree(dataset, w1=1.5, w2=0.7):
+    # w1 * x1 * sin(w2 * x2), coefficients are [w2, w1] in postfix order
+    return op.Tree([variable(dataset, 'x2', w2), op.Node.Sin(), variable(dataset, 'x1', w1), op.Node.Mul()]).UpdateNodes()
+
+
+def finite_differences(tree, double_dataset, h=1e-6):
+    # central differences of the float64 interpreter with respect to every coefficient
+    interpreter, rows = op.Interpreter64(), op.Range(0, ROWS)
+    theta = np.array(tree.GetCoefficients(), dtype=np.float64)
+    columns = []
+    for j in range(len(theta)):
+        step = np.zeros_like(theta)
+        step[j] = h
+        fp = interpreter.Evaluate(tree, double_dataset, rows, coefficients=theta + step)
+        fm = interpreter.Evaluate(tree, double_dataset, rows, coefficients=theta - step)
+        columns.append((fp - fm) / (2 * h))
+    return np.column_stack(columns)
+
+
+def test_linear(dataset, data):
+    interpreter = op.Interpreter()
+    tree = linear_tree(dataset)
+    jacobian = op.EvaluateJacobian(interpreter, tree, dataset, op.Range(0, ROWS))
+    assert jacobian.shape == (ROWS, 3)
+    expected = np.column_stack([data[:, 0], data[:, 1], np.ones(ROWS)])
+    np.testing.assert_allclose(jacobian, expected, rtol=1e-6, atol=1e-7)
+
+
+@pytest.mark.parametrize('tree_fn', [linear_tree, nonlinear_tree])
+def test_finite_differences(dataset, double_dataset, tree_fn):
+    interpreter = op.Interpreter()
+    tree = tree_fn(dataset)
+    jacobian = op.EvaluateJacobian(interpreter, tree, dataset, op.Range(0, ROWS))
+    np.testing.assert_allclose(jacobian, finite_differences(tree, double_dataset), rtol=1e-4, atol=1e-5)
+
+
+def test_range(dataset):
+    interpreter = op.Interpreter()
+    tree = nonlinear_tree(dataset)
+    full = op.EvaluateJacobian(interpreter, tree, dataset, op.Range(0, ROWS))
+    part = op.EvaluateJacobian(interpreter, tree, dataset, op.Range(10, 20))
+    np.testing.assert_allclose(part, full[10:20], rtol=1e-6)
+
+
+def test_variables(dataset, data):
+    interpreter = op.Interpreter()
+    rows = op.Range(0, ROWS)
+    hashes = [dataset.GetVariable(n).Hash for n in ('x1', 'x2', 'y')]
+    x1, x2 = data[:, 0], data[:, 1]
+
+    jacobian = op.EvaluateVariableJacobian(interpreter, linear_tree(dataset), dataset, rows, hashes)
+    assert jacobian.shape == (ROWS, 3)
+    np.testing.assert_allclose(jacobian[:, 0], 2, rtol=1e-6)
+    np.testing.assert_allclose(jacobian[:, 1], -3, rtol=1e-6)
+    np.testing.assert_array_equal(jacobian[:, 2], 0)  # y does not occur in the tree
+
+    w1, w2 = 1.5, 0.7
+    jacobian = op.EvaluateVariableJacobian(interpreter, nonlinear_tree(dataset, w1, w2), dataset, rows, hashes[:2])
+    np.testing.assert_allclose(jacobian[:, 0], w1 * np.sin(w2 * x2), rtol=1e-4, atol=1e-6)
+    np.testing.assert_allclose(jacobian[:, 1], w1 * x1 * w2 * np.cos(w2 * x2), rtol=1e-4, atol=1e-6)
+
+    # a variable used twice: d/dx1 (2 * x1) * (3 * x1) = 12 * x1
+    tree = op.Tree([variable(dataset, 'x1', 3.0), variable(dataset, 'x1', 2.0), op.Node.Mul()]).UpdateNodes()
+    jacobian = op.EvaluateVariableJacobian(interpreter, tree, dataset, rows, hashes[:1])
+    np.testing.assert_allclose(jacobian[:, 0], 12 * x1, rtol=1e-5, atol=1e-6)
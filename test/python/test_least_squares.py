@@ -0,0 +1,72 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import itertools
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+
+DTYPES = [np.float32, np.float64]
+
+
+def sample(rows, cols=None, seed=1234):
+    # target = 2.5 * x - 0.75 plus noise, for every column of x
+    rng = np.random.default_rng(seed)
+    x = rng.normal(size=rows if cols is None else (rows, cols))
+    noise = rng.normal(scale=0.1, size=rows)
+    base = x if cols is None else x[:, 0]
+    return x, 2.5 * base - 0.75 + noise
+
+
+def expected(x, y):
+    return np.polyfit(x.astype(np.float64), y.astype(np.float64), 1)
+
+
+@pytest.mark.parametrize('tx,ty', list(itertools.product(DTYPES, DTYPES)))
+def test_fit(tx, ty):
+    x, y = sample(1000)
+    x, y = x.astype(tx), y.astype(ty)
+    scale, offset = op.FitLeastSquares(x, y)
+    np.testing.assert_allclose([scale, offset], expected(x, y), rtol=1e-5, atol=1e-6)
+
+
+def test_blocks():
+    # more rows than one block, the partial fits are merged
+    x, y = sample(100000)
+    np.testing.assert_allclose(op.FitLeastSquares(x, y), expected(x, y), rtol=1e-8, atol=1e-10)
+
+
+@pytest.mark.parametrize('tx,ty', list(itertools.product(DTYPES, DTYPES)))
+def test_many(tx, ty):
+    x, y = sample(500, 4)
+    x, y = x.astype(tx), y.astype(ty)
+    fits = op.FitLeastSquaresMany(x, y)
+    assert fits.shape == (4, 2)
+    for c in range(4):
+        np.testing.assert_allclose(fits[c], expected(x[:, c], y), rtol=1e-5, atol=1e-6)
+        np.testing.assert_allclose(fits[c], op.FitLeastSquares(np.ascontiguousarray(x[:, c]), y), rtol=1e-5, atol=1e-6)
+
+
+def test_many_layouts():
+    x, y = sample(500, 6)
+    fits = op.FitLeastSquaresMany(x, y)
+    # fortran order, strided columns and rows, a strided target
+    np.testing.assert_allclose(op.FitLeastSquaresMany(np.asfortranarray(x), y), fits, rtol=1e-12, atol=1e-12)
+    np.testing.assert_allclose(op.FitLeastSquaresMany(x[:, ::2], y), fits[::2], rtol=1e-12, atol=1e-12)
+    yy = np.repeat(y, 2)[::2]  # same values, twice the stride
+    np.testing.assert_allclose(op.FitLeastSquaresMany(x[::2], y[::2]), [expected(x[::2, c], y[::2]) for c in range(6)], rtol=1e-6, atol=1e-8)
+    np.testing.assert_allclose(op.FitLeastSquaresMany(x, yy), fits, rtol=1e-12, atol=1e-12)
+    # a one dimensional prediction is a single column
+    np.testing.assert_allclose(op.FitLeastSquaresMany(x[:, 0], y), fits[:1], rtol=1e-12, atol=1e-12)
+
+
+def test_errors():
+    x, y = sample(100, 2)
+    with pytest.raises(RuntimeError):
+        op.FitLeastSquaresMany(x, y[:50])
+    with pytest.raises(RuntimeError):
+        op.FitLeastSquaresMany(x, x)
+    with pytest.raises(RuntimeError):
+        op.FitLeastSquares(x[:, 0].astype(np.float32), y[:50])
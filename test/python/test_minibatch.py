@@ -0,0 +1,58 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+
+import pyoperon as op
+from helpers import ROWS, individual, linear_tree
+
+
+def window(evaluator):
+    r = evaluator.OptimizationRange
+    return r.Start, r.End
+
+
+def test_whole_range_by_default(problem):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error)
+    assert evaluator.BatchSize == 0
+    assert window(evaluator) == (0, ROWS)
+    evaluator.BatchSize = 2 * ROWS
+    assert window(evaluator) == (0, ROWS)
+
+
+def test_window(problem):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error)
+    evaluator.BatchSize = 16
+    evaluator.BatchSeed = 42
+
+    windows = []
+    for _ in range(8):
+        start, end = window(evaluator)
+        assert end - start == 16 and 0 <= start and end <= ROWS
+        # the window is fixed within a generation
+        assert window(evaluator) == (start, end)
+        windows.append((start, end))
+        evaluator.AdvanceGeneration()
+    assert len(set(windows)) > 1
+
+    # the same seed and generation give the same window
+    other = op.Evaluator(problem, interpreter, error)
+    other.BatchSize = 16
+    other.BatchSeed = 42
+    assert window(other) == windows[0]
+
+
+def test_optimize_on_batch(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error, False)
+    evaluator.LocalOptimizationIterations = 50
+    evaluator.BatchSize = 16
+
+    # the data is noise free, so any window recovers the coefficients
+    ind = individual(linear_tree(dataset, 1.0, 1.0, 0.0))
+    fitness = evaluator(op.RomuTrio(1), ind)
+    np.testing.assert_allclose(ind.Genotype.GetCoefficients(), [2, -3, 1], atol=1e-3)
+    # fitness is still computed on the whole training range
+    assert fitness[0] < 1e-6
@@ -0,0 +1,73 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import individual, linear_tree, variable
+
+FLOAT_MAX = np.finfo(np.float32).max
+
+
+class Objectives:
+    """Evaluators for MSE, MAE and length, kept alive together with the metrics and interpreter."""
+
+    def __init__(self, problem, lead_scaling, follower_scaling):
+        self.interpreter, self.mse, self.mae = op.Interpreter(), op.MSE(), op.MAE()
+        self.lead = op.Evaluator(problem, self.interpreter, self.mse, lead_scaling)
+        self.follower = op.Evaluator(problem, self.interpreter, self.mae, follower_scaling)
+        self.length = op.LengthEvaluator(problem)
+        for e in (self.lead, self.follower):
+            e.LocalOptimizationIterations = 0
+        self.multi = op.MultiEvaluator(problem)
+        for e in (self.lead, self.length, self.follower):
+            self.multi.Add(e)
+
+    def separately(self, tree):
+        rng = op.RomuTrio(1)
+        return [e(rng, individual(op.Tree(tree)))[0] for e in (self.lead, self.length, self.follower)]
+
+
+@pytest.mark.parametrize('lead_scaling,follower_scaling', [(True, True), (True, False), (False, True), (False, False)])
+def test_matches_separate_evaluators(problem, dataset, lead_scaling, follower_scaling):
+    objectives = Objectives(problem, lead_scaling, follower_scaling)
+    assert objectives.multi.ObjectiveCount == 3
+
+    tree = linear_tree(dataset, 0.5, 1.0, 0.0)
+    fitness = objectives.multi(op.RomuTrio(1), individual(tree))
+    np.testing.assert_allclose(fitness, objectives.separately(tree), rtol=1e-5, atol=1e-7)
+
+    # the follower reused the prediction of the lead
+    assert objectives.multi.SharedEvaluations == 1
+    assert objectives.follower.ResidualEvaluations == 1  # from separately() only
+
+
+def test_memo_hit(problem, dataset):
+    # after a memo hit of the lead the prediction is computed once for the followers
+    objectives = Objectives(problem, True, True)
+    memo = op.FitnessMemo()
+    objectives.lead.Memo = memo
+    tree = linear_tree(dataset, 0.5, 1.0, 0.0)
+    rng = op.RomuTrio(1)
+    first = objectives.multi(rng, individual(tree))
+    second = objectives.multi(rng, individual(op.Tree(tree)))
+    assert objectives.lead.CacheHits == 1
+    np.testing.assert_allclose(second, first, rtol=1e-6)
+
+
+def test_rejected(problem, dataset):
+    # the pre-filter of the lead rejects the individual for every shared objective
+    objectives = Objectives(problem, True, True)
+    objectives.lead.Bounds = {dataset.GetVariable(n).Hash: (-1.0, 1.0) for n in ('x1', 'x2')}
+    tree = op.Tree([variable(dataset, 'x2'), variable(dataset, 'x1'), op.Node.Div()]).UpdateNodes()
+    fitness = objectives.multi(op.RomuTrio(1), individual(tree))
+    assert fitness[0] == FLOAT_MAX and fitness[2] == FLOAT_MAX
+    assert fitness[1] == objectives.length(op.RomuTrio(1), individual(op.Tree(tree)))[0]
+    assert objectives.lead.RejectedEvaluations == 1
+
+
+def test_advance_generation(problem):
+    objectives = Objectives(problem, True, True)
+    objectives.multi.AdvanceGeneration()
+    assert objectives.lead.Generation == 1 and objectives.follower.Generation == 1
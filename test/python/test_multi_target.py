@@ -0,0 +1,53 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, individual, linear_tree
+
+TARGETS = ['y', 'z', 'w']
+
+
+@pytest.fixture
+def targets_dataset(data):
+    # two more targets next to y: z = x1 - x2 and w = sin(3 * x1)
+    x1, x2 = data[:, 0], data[:, 1]
+    values = np.column_stack([data, x1 - x2, np.sin(3 * x1)])
+    ds = op.Dataset(np.asfortranarray(values, dtype=np.float32))
+    ds.VariableNames = ['x1', 'x2'] + TARGETS
+    return ds
+
+
+def make_problem(ds, target):
+    inputs = op.VariableCollection(v for v in ds.Variables if v.Name in ('x1', 'x2'))
+    return op.Problem(ds, inputs, target, op.Range(0, ROWS), op.Range(0, ROWS))
+
+
+@pytest.mark.parametrize('scaling', [True, False])
+def test_matches_single_target(targets_dataset, scaling):
+    ds = targets_dataset
+    interpreter, error = op.Interpreter(), op.MSE()
+    problem = make_problem(ds, 'y')
+    evaluator = op.MultiTargetEvaluator(problem, interpreter, error, TARGETS, linear_scaling=scaling)
+    assert evaluator.Targets == TARGETS
+    assert evaluator.ObjectiveCount == len(TARGETS)
+
+    tree = linear_tree(ds, 0.5, 1.0, 0.0)
+    fitness = evaluator(op.RomuTrio(1), individual(tree))
+    assert len(fitness) == len(TARGETS)
+    assert evaluator.ResidualEvaluations == 1
+
+    for target, f in zip(TARGETS, fitness):
+        single_problem = make_problem(ds, target)
+        single = op.Evaluator(single_problem, interpreter, error, scaling)
+        single.LocalOptimizationIterations = 0
+        expected = single(op.RomuTrio(1), individual(op.Tree(tree)))[0]
+        np.testing.assert_allclose(f, expected, rtol=1e-4, atol=1e-6)
+
+
+def test_no_targets(targets_dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    with pytest.raises(ValueError):
+        op.MultiTargetEvaluator(make_problem(targets_dataset, 'y'), interpreter, error, [])
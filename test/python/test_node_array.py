@@ -0,0 +1,80 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import gc
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import linear_tree
+
+
+def test_view(dataset):
+    tree = linear_tree(dataset)
+    nodes = tree.NodeArray
+    assert nodes.shape == (tree.Length,)
+    assert not nodes.flags.writeable
+    np.testing.assert_array_equal(nodes['Value'], [n.Value for n in tree.Nodes])
+    np.testing.assert_array_equal(nodes['Arity'], [n.Arity for n in tree.Nodes])
+    np.testing.assert_array_equal(nodes['HashValue'], [n.HashValue for n in tree.Nodes])
+    with pytest.raises(ValueError):
+        nodes['Value'][0] = 0
+
+
+def test_view_keeps_tree_alive(dataset):
+    nodes = linear_tree(dataset).NodeArray
+    gc.collect()
+    np.testing.assert_array_equal(nodes['Value'], [2, -3, 1, 1, 1])
+
+
+def test_buffer_protocol(dataset):
+    view = memoryview(linear_tree(dataset))
+    assert view.readonly
+    assert view.nbytes == view.itemsize * 5
+
+
+def test_from_node_array(dataset):
+    tree = linear_tree(dataset)
+    nodes = tree.NodeArray.copy()
+    nodes['Value'][0] = 4
+    modified = op.Tree.FromNodeArray(nodes)
+    assert modified[0].Value == 4
+    assert [n.Value for n in modified.Nodes][1:] == [n.Value for n in tree.Nodes][1:]
+    assert modified.Length == tree.Length
+    # the original tree is unchanged
+    assert tree[0].Value == 2
+
+
+def test_from_node_array_subset_of_fields(dataset):
+    nodes = linear_tree(dataset).NodeArray
+    names = ['Type', 'Arity', 'HashValue', 'Value', 'IsEnabled']
+    subset = np.empty(len(nodes), dtype=[(n, nodes.dtype[n]) for n in names])
+    for n in names:
+        subset[n] = nodes[n]
+    tree = op.Tree.FromNodeArray(subset)
+    np.testing.assert_array_equal(tree.NodeArray['Value'], nodes['Value'])
+
+
+def test_from_invalid_node_array(dataset):
+    nodes = linear_tree(dataset).NodeArray
+
+    with pytest.raises(RuntimeError):
+        op.Tree.FromNodeArray(np.zeros(5))
+
+    missing = np.empty(len(nodes), dtype=[('Type', nodes.dtype['Type']), ('Value', nodes.dtype['Value'])])
+    with pytest.raises(RuntimeError):
+        op.Tree.FromNodeArray(missing)
+
+    unknown = nodes.copy()
+    unknown['Type'][0] = 3
+    with pytest.raises(RuntimeError):
+        op.Tree.FromNodeArray(unknown)
+
+    arity = nodes.copy()
+    arity['Arity'][2] = 3
+    with pytest.raises(RuntimeError):
+        op.Tree.FromNodeArray(arity)
+
+    with pytest.raises(RuntimeError):
+        op.Tree.FromNodeArray(nodes[:-1])
@@ -0,0 +1,37 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+
+import pyoperon as op
+from helpers import ROWS, linear_tree
+
+
+def test_optimize_many(dataset):
+    trees = [linear_tree(dataset, 1.0, 1.0, 0.0), op.Tree([op.Node.Constant(0.0)]).UpdateNodes(), linear_tree(dataset, -1.0, 0.5, 2.0)]
+    target = dataset.GetValues('y')
+    rows = op.Range(0, ROWS)
+
+    coefficients, summaries = op.OptimizeMany(trees, dataset, target, rows, iterations=50, nthread=2)
+    assert coefficients.shape == (len(trees), 3)
+    assert len(summaries) == len(trees)
+
+    np.testing.assert_allclose(coefficients[0], [2, -3, 1], atol=1e-3)
+    np.testing.assert_allclose(coefficients[2], [2, -3, 1], atol=1e-3)
+    # the constant model fits the mean, shorter rows are padded with NaN
+    np.testing.assert_allclose(coefficients[1, 0], np.mean(target), atol=1e-3)
+    assert np.isnan(coefficients[1, 1:]).all()
+
+    # each tree gets the same result as a single call
+    interpreter = op.Interpreter()
+    for tree, row, summary in zip(trees, coefficients, summaries):
+        single, single_summary = op.Optimize(interpreter, tree, dataset, target, rows, iterations=50)
+        np.testing.assert_allclose(row[:len(single)], single, rtol=1e-6)
+        assert summary.FinalCost <= summary.InitialCost
+        assert summary.Iterations == single_summary.Iterations
+
+
+def test_optimize_many_empty(dataset):
+    coefficients, summaries = op.OptimizeMany([], dataset, dataset.GetValues('y'), op.Range(0, ROWS), iterations=10)
+    assert coefficients.shape == (0, 0)
+    assert summaries == []
@@ -0,0 +1,82 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import gc
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import individual, linear_tree
+
+FITNESS = [(1.05, 0.0), (1.0, 5.0), (2.0, 2.0), (0.5, 6.0)]
+
+
+@pytest.fixture
+def individuals(dataset):
+    trees = [linear_tree(dataset), op.Tree([op.Node.Constant(1.0)]).UpdateNodes()]
+    return [individual(trees[i % 2], *f) for i, f in enumerate(FITNESS)]
+
+
+def test_views(individuals):
+    pop = op.Population(individuals)
+    lengths = [ind.Genotype.Length for ind in individuals]
+
+    assert len(pop) == pop.Size == 4
+    assert pop.ObjectiveCount == 2
+    np.testing.assert_allclose(pop.Fitness, np.array(FITNESS, dtype=np.float32))
+    np.testing.assert_array_equal(pop.Offsets, np.concatenate([[0], np.cumsum(lengths)]))
+
+    nodes = pop.NodeArray
+    assert len(nodes) == sum(lengths)
+    assert not nodes.flags.writeable
+    with pytest.raises(ValueError):
+        nodes['Value'][0] = 0
+
+
+def test_fitness_is_shared(individuals):
+    pop = op.Population(individuals)
+    fitness = pop.Fitness
+    fitness[1, 0] = 42
+    assert pop[1].GetFitness(0) == 42
+
+
+def test_views_keep_population_alive(individuals):
+    # views of a temporary population must stay valid after it goes out of scope
+    offsets = op.IndividualCollection(individuals).ToPopulation().Offsets
+    rank = op.IndividualCollection(individuals).ToPopulation().Rank
+    gc.collect()
+    np.testing.assert_array_equal(offsets, [0, 5, 6, 11, 12])
+    assert len(rank) == len(individuals)
+
+
+def test_individuals_round_trip(individuals):
+    pop = op.Population(individuals)
+    for original, restored in zip(individuals, pop.Individuals):
+        assert [n.Value for n in restored.Genotype.Nodes] == [n.Value for n in original.Genotype.Nodes]
+        assert restored.GetFitness(0) == original.GetFitness(0)
+        assert restored.GetFitness(1) == original.GetFitness(1)
+    assert pop.Genotype(0).Length == individuals[0].Genotype.Length
+    with pytest.raises(IndexError):
+        pop[len(individuals)]
+
+
+def test_mismatched_objectives(dataset):
+    tree = linear_tree(dataset)
+    with pytest.raises(RuntimeError):
+        op.Population([individual(tree, 1.0, 2.0), individual(tree, 1.0)])
+
+
+def test_nondominated_sort(individuals):
+    pop = op.Population(individuals)
+    fronts = pop.NondominatedSort()
+    assert [sorted(f) for f in fronts] == [[0, 1, 3], [2]]
+    np.testing.assert_array_equal(pop.Rank, [0, 0, 1, 0])
+
+
+def test_nondominated_sort_eps(individuals):
+    # with eps = 0.1, (1.05, 0) also dominates (1, 5)
+    pop = op.Population(individuals)
+    fronts = pop.NondominatedSort(eps=0.1)
+    assert [sorted(f) for f in fronts] == [[0, 3], [1, 2]]
+    np.testing.assert_array_equal(pop.Rank, [0, 1, 1, 0])
@@ -0,0 +1,129 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import pathlib
+import shutil
+import subprocess
+import sys
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, variable
+
+INCLUDE = pathlib.Path(__file__).resolve().parents[2] / 'include'
+
+# cube has a double derivative only (the float one goes through it), step has none
+PLUGIN = r'''
+#include <pyoperon/plugin.h>
+
+static void cube_f32(float const* const* args, size_t n, float* out)
+{
+    for (size_t i = 0; i < n; ++i) { out[i] = args[0][i] * args[0][i] * args[0][i]; }
+}
+
+static void cube_f64(double const* const* args, size_t n, double* out)
+{
+    for (size_t i = 0; i < n; ++i) { out[i] = args[0][i] * args[0][i] * args[0][i]; }
+}
+
+static void cube_derivative_f64(double const* const* args, size_t n, size_t index, double* out)
+{
+    (void)index;
+    for (size_t i = 0; i < n; ++i) { out[i] = 3 * args[0][i] * args[0][i]; }
+}
+
+static void step_f32(float const* const* args, size_t n, float* out)
+{
+    for (size_t i = 0; i < n; ++i) { out[i] = args[0][i] > 0 ? 1.0f : 0.0f; }
+}
+
+static pyoperon_primitive const primitives[] = {
+    { PYOPERON_PLUGIN_ABI_VERSION, "test.cube", 1, cube_f32, cube_f64, 0, cube_derivative_f64 },
+    { PYOPERON_PLUGIN_ABI_VERSION, "test.step", 1, step_f32, 0, 0, 0 },
+};
+
+PYOPERON_PLUGIN_EXPORT pyoperon_primitive const* pyoperon_primitives(size_t* count)
+{
+    *count = sizeof(primitives) / sizeof(primitives[0]);
+    return primitives;
+}
+'''
+
+
+@pytest.fixture(scope='module')
+def plugin(tmp_path_factory):
+    compiler = shutil.which('cc') or shutil.which('gcc') or shutil.which('clang')
+    if sys.platform == 'win32' or compiler is None:
+        pytest.skip('no C compiler to build the test plugin')
+    path = tmp_path_factory.mktemp('plugin')
+    source, library = path / 'plugin.c', path / 'libtestplugin.so'
+    source.write_text(PLUGIN)
+    subprocess.run([compiler, '-shared', '-fPIC', '-O2', f'-I{INCLUDE}', str(source), '-o', str(library)], check=True)
+    # the registry is process-wide, the plugin can only be loaded once
+    assert sorted(op.LoadPrimitives(str(library))) == ['test.cube', 'test.step']
+    return library
+
+
+def unary_tree(dataset, name, weight=1.0):
+    return op.Tree([variable(dataset, 'x1', weight), op.Node.Dyn(name)]).UpdateNodes()
+
+
+def test_errors(tmp_path):
+    with pytest.raises(RuntimeError):
+        op.LoadPrimitives(str(tmp_path / 'missing.so'))
+    with pytest.raises(RuntimeError):
+        op.Node.Dyn('test.unknown')
+    with pytest.raises(RuntimeError):
+        op.DispatchTable().RegisterPrimitive('test.unknown')
+
+
+def test_hash():
+    assert op.PrimitiveHash('test.cube') == op.PrimitiveHash('test.cube')
+    assert op.PrimitiveHash('test.cube') != op.PrimitiveHash('test.step')
+
+
+def test_load(plugin):
+    assert {'test.cube', 'test.step'} <= set(op.Primitives())
+    with pytest.raises(RuntimeError):
+        op.LoadPrimitives(str(plugin))  # already registered
+    node = op.Node.Dyn('test.cube')
+    assert node.Type == op.NodeType.Dyn
+    assert node.HashValue == op.PrimitiveHash('test.cube')
+    assert node.Arity == 1
+
+
+def test_evaluate(plugin, dataset, data):
+    tree = unary_tree(dataset, 'test.cube', 0.5)
+    rows = op.Range(0, ROWS)
+    expected = (0.5 * data[:, 0]) ** 3
+    np.testing.assert_allclose(op.Interpreter32().Evaluate(tree, dataset, rows), expected, rtol=1e-5, atol=1e-7)
+
+    table = op.DispatchTable()
+    table.RegisterPrimitives()
+    interpreter = op.Interpreter(table)
+    np.testing.assert_allclose(op.Evaluate(interpreter, tree, dataset, rows), expected, rtol=1e-5, atol=1e-7)
+
+    # d/dw (w * x1)^3 = 3 * w^2 * x1^3, through the double derivative kernel
+    jacobian = op.EvaluateJacobian(interpreter, tree, dataset, rows)
+    np.testing.assert_allclose(jacobian[:, 0], 3 * 0.5 ** 2 * data[:, 0] ** 3, rtol=1e-4, atol=1e-6)
+
+
+def test_not_differentiable(plugin, dataset):
+    tree = unary_tree(dataset, 'test.step', 0.5)
+    rows = op.Range(0, ROWS)
+    table = op.DispatchTable()
+    table.RegisterPrimitive('test.step')
+    interpreter = op.Interpreter(table)
+
+    values = op.Evaluate(interpreter, tree, dataset, rows)
+    np.testing.assert_array_equal(values, (dataset.GetValues('x1') > 0).astype(np.float32))
+
+    with pytest.raises(RuntimeError):
+        op.EvaluateJacobian(interpreter, tree, dataset, rows)
+
+    # local optimization leaves the tree alone
+    coefficients, summary = op.Optimize(interpreter, tree, dataset, dataset.GetValues('y'), rows, iterations=10)
+    assert coefficients == tree.GetCoefficients()
+    assert summary.Iterations == 0 and not summary.Success
@@ -0,0 +1,67 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, variable
+
+
+@pytest.fixture
+def exp_data(data):
+    # y = 0.7 * exp(1.3 * x1) - 0.2
+    x1 = data[:, 0]
+    return np.column_stack([x1, 0.7 * np.exp(1.3 * x1) - 0.2])
+
+
+@pytest.fixture
+def exp_dataset(exp_data):
+    ds = op.DoubleDataset(exp_data)
+    ds.VariableNames = ['x1', 'y']
+    return ds
+
+
+def exp_tree(ds, weight):
+    return op.Tree([variable(ds.Dataset, 'x1', weight), op.Node.Exp()]).UpdateNodes()
+
+
+def test_refit(exp_dataset, exp_data):
+    tree = exp_tree(exp_dataset, 1.0)
+    y = exp_data[:, 1]
+    rows = op.Range(0, ROWS)
+    result = op.Refit(tree, exp_dataset, y, rows, iterations=100)
+
+    # float64 accuracy, beyond what the float32 search can reach
+    np.testing.assert_allclose(result.Coefficients, [1.3], atol=1e-7)
+    np.testing.assert_allclose([result.Scale, result.Offset], [0.7, -0.2], atol=1e-7)
+    assert 0 < result.Iterations <= 100
+    assert result.FinalCost < result.InitialCost
+    assert result.FinalCost < 1e-14
+
+    prediction = op.Interpreter64().Evaluate(tree, exp_dataset, rows, coefficients=np.array(result.Coefficients))
+    np.testing.assert_allclose(result.Scale * prediction + result.Offset, y, atol=1e-6)
+
+    # the tree itself is not modified
+    assert tree.GetCoefficients() == [1]
+
+
+def test_refit_many(exp_dataset, exp_data):
+    trees = [exp_tree(exp_dataset, w) for w in (0.5, 1.0, 2.0)]
+    y = exp_data[:, 1]
+    rows = op.Range(0, ROWS)
+    results = op.RefitMany(trees, exp_dataset, y, rows, iterations=100, nthread=2)
+    assert len(results) == len(trees)
+    for tree, result in zip(trees, results):
+        single = op.Refit(tree, exp_dataset, y, rows, iterations=100)
+        np.testing.assert_allclose(result.Coefficients, single.Coefficients, rtol=1e-12)
+        assert (result.Scale, result.Offset) == pytest.approx((single.Scale, single.Offset), rel=1e-12)
+
+
+def test_refit_target(exp_dataset, exp_data):
+    tree = exp_tree(exp_dataset, 1.0)
+    # float32 targets are converted
+    result = op.Refit(tree, exp_dataset, exp_data[:, 1].astype(np.float32), op.Range(0, ROWS))
+    np.testing.assert_allclose(result.Coefficients, [1.3], atol=1e-4)
+    with pytest.raises(RuntimeError):
+        op.Refit(tree, exp_dataset, exp_data[:10, 1], op.Range(0, ROWS))
@@ -0,0 +1,52 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import math
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, GeneticProgramming, individual
+
+
+def test_schedule(problem):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error)
+    assert evaluator.SampleFraction == 1
+    assert evaluator.FitnessRange.Size == ROWS
+
+    evaluator.InitialFraction = 0.25
+    evaluator.SamplingGenerations = 4
+    fractions = []
+    for _ in range(6):
+        fractions.append(evaluator.SampleFraction)
+        r = evaluator.FitnessRange
+        assert r.Size == math.ceil(evaluator.SampleFraction * ROWS)
+        assert 0 <= r.Start and r.End <= ROWS
+        evaluator.AdvanceGeneration()
+    np.testing.assert_allclose(fractions, [0.25, 0.4375, 0.625, 0.8125, 1, 1])
+
+    evaluator.ResetSchedule()
+    assert evaluator.SampleFraction == 0.25
+
+    with pytest.raises(ValueError):
+        evaluator.InitialFraction = 0
+    with pytest.raises(ValueError):
+        evaluator.InitialFraction = 1.5
+
+
+def test_final_population_full_range(problem, inputs):
+    # the run ends before the schedule completes, the parents are re-scored on the full range
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error, True)
+    evaluator.LocalOptimizationIterations = 0
+    evaluator.InitialFraction = 0.25
+    evaluator.SamplingGenerations = 100
+    gp = GeneticProgramming(problem, inputs, evaluator, generations=3)
+    best = gp.run(threads=2).BestModel
+
+    reference = op.Evaluator(problem, interpreter, error, True)
+    reference.LocalOptimizationIterations = 0
+    fitness = reference(op.RomuTrio(1), individual(op.Tree(best.Genotype)))
+    np.testing.assert_allclose(best.GetFitness(0), fitness[0], rtol=1e-4, atol=1e-7)
@@ -0,0 +1,53 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, individual, linear_tree
+
+
+@pytest.mark.parametrize('dtype', [np.float32, np.float64])
+def test_scaled_evaluate(dataset, data, dtype):
+    # y = 2 * (x1 - 1.5 * x2) + 1
+    interpreter = op.Interpreter()
+    tree = linear_tree(dataset, 1.0, -1.5, 0.0)
+    prediction, scale, offset = op.ScaledEvaluate(interpreter, tree, dataset, op.Range(0, ROWS), data[:, 2].astype(dtype))
+    # the prediction is returned unscaled
+    np.testing.assert_allclose(prediction, data[:, 0] - 1.5 * data[:, 1], rtol=1e-5, atol=1e-6)
+    np.testing.assert_allclose(prediction, op.Evaluate(interpreter, tree, dataset, op.Range(0, ROWS)))
+    np.testing.assert_allclose([scale, offset], [2, 1], atol=1e-4)
+
+
+def test_range(dataset, data):
+    # the target is aligned with the range, a longer one is truncated
+    interpreter = op.Interpreter()
+    tree = linear_tree(dataset, 1.0, -1.5, 0.0)
+    prediction, scale, offset = op.ScaledEvaluate(interpreter, tree, dataset, op.Range(8, 40), data[8:, 2])
+    assert prediction.shape == (32,)
+    np.testing.assert_allclose([scale, offset], [2, 1], atol=1e-4)
+    np.testing.assert_allclose(np.polyfit(prediction, data[8:40, 2], 1), [scale, offset], rtol=1e-4, atol=1e-5)
+
+
+def test_errors(dataset, data):
+    interpreter = op.Interpreter()
+    tree = linear_tree(dataset)
+    with pytest.raises(RuntimeError):
+        op.ScaledEvaluate(interpreter, tree, dataset, op.Range(0, ROWS), data[:10, 2])
+    with pytest.raises(RuntimeError):
+        op.ScaledEvaluate(interpreter, tree, dataset, op.Range(0, ROWS), data)
+
+
+def test_evaluator(problem, dataset, data):
+    # the fused fit gives the same error as scaling the prediction afterwards
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error, True)
+    evaluator.LocalOptimizationIterations = 0
+    tree = linear_tree(dataset, 0.5, 1.0, 0.3)
+    fitness = evaluator(op.RomuTrio(1), individual(tree))[0]
+
+    y = dataset.GetValues('y').astype(np.float64)
+    prediction = op.Evaluate(interpreter, tree, dataset, op.Range(0, ROWS)).astype(np.float64)
+    scale, offset = np.polyfit(prediction, y, 1)
+    np.testing.assert_allclose(fitness, np.mean((scale * prediction + offset - y) ** 2), rtol=1e-4)
@@ -0,0 +1,75 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import pickle
+import struct
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, linear_tree
+
+HEADER_SIZE = 12
+
+
+def fields(tree):
+    return [(n.Type, n.Arity, n.HashValue, n.Value, n.IsEnabled) for n in tree.Nodes]
+
+
+def test_bytes_round_trip(dataset):
+    tree = linear_tree(dataset, w1=0.25, w2=-1.5, c=3.0)
+    buf = tree.ToBytes()
+    assert buf[:4] == b'OPTR'
+    (count,) = struct.unpack_from('<I', buf, 8)
+    assert count == tree.Length
+
+    restored = op.Tree.FromBytes(buf)
+    assert fields(restored) == fields(tree)
+    assert restored.Length == tree.Length
+    assert restored.Depth == tree.Depth
+
+    interpreter = op.Interpreter()
+    rows = op.Range(0, ROWS)
+    np.testing.assert_array_equal(op.Evaluate(interpreter, restored, dataset, rows),
+                                  op.Evaluate(interpreter, tree, dataset, rows))
+
+
+def test_pickle(dataset):
+    tree = linear_tree(dataset)
+    restored = pickle.loads(pickle.dumps(tree))
+    assert fields(restored) == fields(tree)
+
+
+def test_legacy_pickle_state(dataset):
+    # earlier releases pickled a list of nodes
+    tree = linear_tree(dataset)
+    restored = op.Tree.__new__(op.Tree)
+    restored.__setstate__((list(tree.Nodes),))
+    assert fields(restored) == fields(tree)
+
+
+def corrupt(buf, offset, fmt, value):
+    buf = bytearray(buf)
+    struct.pack_into(fmt, buf, offset, value)
+    return bytes(buf)
+
+
+def test_corrupt_buffers(dataset):
+    buf = linear_tree(dataset).ToBytes()
+    record = (len(buf) - HEADER_SIZE) // linear_tree(dataset).Length
+
+    bad = [
+        buf[:-1],                                    # truncated
+        corrupt(buf, 0, '<4s', b'XXXX'),             # magic
+        corrupt(buf, 4, '<H', 99),                   # version
+        corrupt(buf, 8, '<I', 6),                    # node count
+        corrupt(buf, HEADER_SIZE, '<I', 3),          # two type bits
+        corrupt(buf, HEADER_SIZE, '<I', 1 << 31),    # type out of range
+        corrupt(buf, HEADER_SIZE + 4, '<H', 1),      # terminal with an argument
+        corrupt(buf, HEADER_SIZE + 2 * record + 4, '<H', 3),  # arity exceeds the stack
+        buf[:8] + struct.pack('<I', 4) + buf[HEADER_SIZE:-record],  # two roots
+    ]
+    for b in bad:
+        with pytest.raises(RuntimeError):
+            op.Tree.FromBytes(b)
@@ -0,0 +1,93 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, individual, linear_tree, variable
+
+
+def redundant_tree(dataset):
+    # (2 * x1 + 3 * x1) + (x2 - x2) * 4 + (1 + 0), which is 5 * x1 + 1
+    return op.Tree([
+        op.Node.Constant(0.0), op.Node.Constant(1.0), op.Node.Add(),
+        op.Node.Constant(4.0), variable(dataset, 'x2'), variable(dataset, 'x2'), op.Node.Sub(), op.Node.Mul(),
+        variable(dataset, 'x1', 3.0), variable(dataset, 'x1', 2.0), op.Node.Add(),
+        op.Node.Add(), op.Node.Add(),
+    ]).UpdateNodes()
+
+
+def values(tree, dataset):
+    return op.Evaluate(op.Interpreter(), tree, dataset, op.Range(0, ROWS))
+
+
+def test_simplify(dataset, data):
+    tree = redundant_tree(dataset)
+    simplified = tree.Simplify()
+    assert simplified.Length == 3  # 5 * x1 + 1
+    assert sorted(simplified.GetCoefficients()) == pytest.approx([1, 5])
+    np.testing.assert_allclose(values(simplified, dataset), 5 * data[:, 0] + 1, rtol=1e-5, atol=1e-6)
+    np.testing.assert_allclose(values(simplified, dataset), values(tree, dataset), rtol=1e-5, atol=1e-6)
+    assert tree.Length == 13  # the original is left alone
+
+    # nested sums are merged into one n-ary node
+    tree = linear_tree(dataset)
+    simplified = tree.Simplify()
+    assert simplified.Length == tree.Length - 1
+    np.testing.assert_allclose(values(simplified, dataset), values(tree, dataset), rtol=1e-5, atol=1e-6)
+
+
+def test_simplify_many(dataset):
+    trees = [redundant_tree(dataset), linear_tree(dataset), op.Tree([variable(dataset, 'x1'), variable(dataset, 'x1'), op.Node.Div()]).UpdateNodes()]
+    simplified = op.SimplifyMany(trees, nthread=2)
+    assert len(simplified) == len(trees)
+    for tree, s in zip(trees, simplified):
+        assert s.Length <= tree.Length
+        assert s.Length == tree.Simplify().Length
+        np.testing.assert_allclose(values(s, dataset), values(tree, dataset), rtol=1e-5, atol=1e-6)
+    assert simplified[2].Length == 1  # x1 / x1 = 1
+
+
+def test_evaluator(problem, dataset):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error, True)
+    evaluator.LocalOptimizationIterations = 0
+    assert not evaluator.Simplify
+
+    ind = individual(redundant_tree(dataset))
+    fitness = evaluator(op.RomuTrio(1), ind)[0]
+    assert ind.Genotype.Length == 13
+
+    evaluator.Simplify = True
+    ind = individual(redundant_tree(dataset))
+    assert evaluator(op.RomuTrio(1), ind)[0] == pytest.approx(fitness, rel=1e-4)
+    assert ind.Genotype.Length == 3
+
+
+def test_estimator():
+    pytest.importorskip('sklearn')
+    from pyoperon.sklearn import SymbolicRegressor
+
+    rng = np.random.default_rng(1234)
+    X = rng.uniform(-1, 1, size=(100, 2))
+    y = X[:, 0] * X[:, 1] + np.sin(X[:, 0])
+
+    params = dict(population_size=50, generations=5, local_iterations=5, simplify=True, random_state=1234)
+    reference = SymbolicRegressor(**params).fit(X, y)
+    est = SymbolicRegressor(refit_iterations=20, **params).fit(X, y)
+    assert reference.model_coefficients_ is None
+
+    # the float64 coefficients cover every coefficient of the scaled model
+    assert len(est.model_coefficients_) == est.model_.CoefficientsCount
+    prediction = est.predict(X)
+    assert prediction.shape == (len(X), 1)
+    assert np.all(np.isfinite(prediction))
+
+    # the search is the same, the refit only lowers the training error of its result
+    mse = lambda e: np.mean((e.predict(X)[:, 0] - y) ** 2)
+    assert mse(est) <= mse(reference) * (1 + 1e-4) + 1e-10
+
+    # the model is not modified when its objectives are computed
+    coefficients = est.model_.GetCoefficients()
+    np.testing.assert_allclose(coefficients, est.model_coefficients_.astype(np.float32), rtol=1e-6)
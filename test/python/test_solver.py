@@ -0,0 +1,50 @@
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright 2019-2021 Heal Research
+
+import numpy as np
+import pytest
+
+import pyoperon as op
+from helpers import ROWS, individual, linear_tree
+
+SOLVERS = [op.SolverType.Eigen, op.SolverType.Tiny, op.SolverType.Auto]
+
+
+def test_select_solver():
+    assert op.SelectSolver(3, 1000) == op.SolverType.Tiny
+    assert op.SelectSolver(20, 1000) == op.SolverType.Eigen
+    expected = op.SolverType.Ceres if op.CeresAvailable() else op.SolverType.Eigen
+    assert op.SelectSolver(20, 1 << 22) == expected
+
+
+@pytest.mark.parametrize('solver', SOLVERS)
+def test_optimize(dataset, solver):
+    interpreter = op.Interpreter()
+    tree = linear_tree(dataset, 1.0, 1.0, 0.0)
+    coefficients, summary = op.Optimize(interpreter, tree, dataset, dataset.GetValues('y'), op.Range(0, ROWS), iterations=50, solver=solver)
+    np.testing.assert_allclose(coefficients, [2, -3, 1], atol=1e-3)
+    assert summary.FinalCost < summary.InitialCost
+
+
+def test_ceres_unavailable(dataset):
+    if op.CeresAvailable():
+        pytest.skip('operon was built with ceres')
+    with pytest.raises(RuntimeError):
+        op.Optimize(op.Interpreter(), linear_tree(dataset, 1.0, 1.0, 0.0), dataset, dataset.GetValues('y'),
+                    op.Range(0, ROWS), iterations=10, solver=op.SolverType.Ceres)
+
+
+@pytest.mark.parametrize('solver', SOLVERS)
+def test_evaluator_solver(problem, dataset, solver):
+    interpreter, error = op.Interpreter(), op.MSE()
+    evaluator = op.Evaluator(problem, interpreter, error, False)
+    # the default is Eigen regardless of how operon was built
+    assert evaluator.Solver == op.SolverType.Eigen
+    evaluator.Solver = solver
+    assert evaluator.Solver == solver
+    evaluator.LocalOptimizationIterations = 50
+
+    ind = individual(linear_tree(dataset, 1.0, 1.0, 0.0))
+    fitness = evaluator(op.RomuTrio(1), ind)
+    assert fitness[0] < 1e-6
+    np.testing.assert_allclose(ind.Genotype.GetCoefficients(), [2, -3, 1], atol=1e-3)